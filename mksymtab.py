@@ -0,0 +1,41 @@
+# Sort the PicoLisp built-in function table by name
+#
+# Reads the preprocessed src/picolisp/src/symbols.h and writes symtab.h,
+# so that tab.c can binary search the table in ROM without sorting an
+# index in RAM at boot.
+import re, sys
+
+_entry = re.compile( r'\{\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\}' )
+
+def _unescape( s ):
+  return re.sub( r'\\(.)', r'\1', s )
+
+# text - the preprocessor output of symbols.h
+# outname - the name of the C output
+# Returns True for OK, False for error
+def mksymtab( text, outname ):
+  start = text.find( "PICOLISP_SYMBOLS" )
+  if start < 0:
+    print( "mksymtab: marker not found" )
+    return False
+  # A module may be listed twice, e.g. as platform and as target library
+  syms = sorted( set( [ ( _unescape( n ), f, n ) for f, n in _entry.findall( text[ start: ] ) ] ) )
+  for i in range( 1, len( syms ) ):
+    if syms[ i ][ 0 ] == syms[ i - 1 ][ 0 ]:
+      print( "mksymtab: conflicting definitions of '%s'" % syms[ i ][ 0 ] )
+      return False
+  outfile = open( outname, "w" )
+  outfile.write( "/* Generated by mksymtab.py from symbols.h, do not edit */\n\n" )
+  outfile.write( "#define SYMLEN %d\n\n" % max( [ len( s[ 0 ] ) for s in syms ] ) )
+  outfile.write( "static const symInit Symbols[] = {\n" )
+  for s in syms:
+    outfile.write( '   {%s, "%s"},\n' % ( s[ 1 ], s[ 2 ] ) )
+  outfile.write( "};\n" )
+  outfile.close()
+  return True
+
+if __name__ == "__main__":
+  if len( sys.argv ) != 2:
+    print( "usage: cpp symbols.h | python mksymtab.py symtab.h" )
+    sys.exit( 1 )
+  sys.exit( not mksymtab( sys.stdin.read(), sys.argv[ 1 ] ) )
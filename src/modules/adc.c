@@ -186,7 +186,6 @@ any plisp_adc_getsamples(any ex) {
   unsigned id, i;
   u16 bcnt, count = 0;
   any x, y;
-  cell c1;
 
   x = cdr(ex);
   NeedNum(ex, y = EVAL(car(x)));
@@ -209,12 +208,16 @@ any plisp_adc_getsamples(any ex) {
   if (count > bcnt)
     count = bcnt;
 
-  // Make the list of adc samples
-  Push(c1, y = cons(box(adc_get_processed_sample(id)), Nil));
-  for (i = 1; i < count - 1; i++)
-    Push(c1, y = cons(box(adc_get_processed_sample(id)), y));
+  if (count == 0)
+    return Nil;
+
+  // Make the list of adc samples, oldest first
+  Root(c1, y = cons(box(adc_get_processed_sample(id)), Nil));
+  for (i = 1; i < count; i++)
+    y = cdr(y) = cons(box(adc_get_processed_sample(id)), Nil);
 
-  return Pop(c1);
+  Unroot(c1);
+  return data(c1);
 #else
   err(NULL, NULL, "BUF_ENABLE_ADC not defined");
 #endif
@@ -227,14 +230,16 @@ any plisp_adc_getsamples(any ex) {
 // new list with the inserted value.
 
 static any ins_element(any list, int pos, int value) {
-  any temp, tab;
+  any temp;
   int i;
 
-  tab = temp = list;
-  temp = cons(box(value), nCdr(pos - 1, temp));
-  for (i = pos - 1; i > 0; i--) {
-    temp = cons(car(nth(i, tab)), temp);
-  }
+  Root(c1, list);
+  Root(c2, temp = cons(box(value), nCdr(pos - 1, list)));
+  for (i = pos - 1; i > 0; i--)
+    data(c2) = temp = cons(car(nth(i, list)), temp);
+
+  Unroot(c2);
+  Unroot(c1);
   return temp;
 }
 
@@ -253,7 +258,7 @@ any plisp_adc_insertsamples(any ex) {
   // get the list of samples
   x = cdr(x);
   NeedLst(ex, y = EVAL(car(x)));
-  tab = y;
+  Root(c1, tab = y);
 
   x = cdr(x);
   NeedNum(ex, y = EVAL(car(x)));
@@ -270,8 +275,9 @@ any plisp_adc_insertsamples(any ex) {
   bcnt = adc_wait_samples(id, count);
 
   for (i = startidx; i < (count + startidx); i++)
-    tab = ins_element(tab, i, adc_get_processed_sample(id));
+    data(c1) = tab = ins_element(tab, i, adc_get_processed_sample(id));
 
+  Unroot(c1);
   return tab;
 #else
   err(NULL, NULL, "BUF_ENABLE_ADC not defined");
@@ -78,9 +78,13 @@ any plisp_can_recv(any ex) {
 			&idtype,
 			&len,
 			data) == PLATFORM_OK) {
-    Push(c1, y = cons(mkStr((char *)data), Nil));
-    Push(c1, y = cons(box(idtype), y));
-    Push(c1, y = cons(box(canid), y));
+    char buf[sizeof(data) + 1];
+
+    memcpy(buf, data, len);
+    buf[len] = '\0';
+    Push(c1, y = cons(mkStr(buf), Nil));
+    data(c1) = y = cons(box(idtype), y);
+    data(c1) = y = cons(box(canid), y);
     return Pop(c1);
   } else {
     return Nil;
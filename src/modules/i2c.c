@@ -7,6 +7,7 @@
 #include "platform.h"
 #include <string.h>
 #include <ctype.h>
+#include <stdlib.h>
 
 // ****************************************************************************
 // I2C module for picoLisp.
@@ -94,17 +95,17 @@ static void outString_i2c(unsigned id, char *s) {
     platform_i2c_send_byte(id, *s++);
 }
 
-static void outNum_i2c(unsigned id, long n) {
-  char buf[BITS/2];
+static void outNum_i2c(unsigned id, any x) {
+  char buf[numSize(x)];
 
-  bufNum(buf, n);
+  bufBig(buf, x);
   outString_i2c(id, buf);
 }
 
 static void i2ch_prin(unsigned id, any x) {
   if (!isNil(x)) {
     if (isNum(x))
-      outNum_i2c(id, unBox(x));
+      outNum_i2c(id, x);
     else if (isSym(x)) {
       int i, c;
       word w;
@@ -161,6 +162,7 @@ any plisp_i2c_read(any ex) {
   unsigned id;
   u32 size, i, count = 0;
   int data;
+  char *b;
   any x, y;
 
   x = cdr(ex);
@@ -171,16 +173,19 @@ any plisp_i2c_read(any ex) {
   x = cdr(x);
   NeedNum(ex, y = EVAL(car(x)));
   size = unBox(y); // get size.
-  char *b = malloc(size + 1);
-
   if (size == 0)
     return Nil;
+  if (!(b = malloc(size + 1)))
+    giveup("No memory");
   for (i = 0; i < size; i++) {
     if ((data = platform_i2c_recv_byte(id, i < size - 1)) == -1)
       break;
     else
       b[count++] = (char)data;
   }
-  return mkStr(b);
+  b[count] = '\0';
+  y = mkStr(b);
+  free(b);
+  return y;
 }
 
@@ -89,7 +89,8 @@
   PICOLISP_LIB_DEFINE(plisp_spi_sson, spi-sson),\
   PICOLISP_LIB_DEFINE(plisp_spi_ssoff, spi-ssoff),\
   PICOLISP_LIB_DEFINE(plisp_spi_setup, spi-setup),\
-  PICOLISP_LIB_DEFINE(plisp_spi_write, spi-write),
+  PICOLISP_LIB_DEFINE(plisp_spi_write, spi-write),\
+  PICOLISP_LIB_DEFINE(plisp_spi_readwrite, spi-readwrite),
 
 // gpio module.
 #define PICOLISP_MOD_PIO\
@@ -289,7 +289,7 @@ emit_static emit_ret_type emit_pio_decode() {
 #endif
 
   Push(c1, y = cons(box(port), Nil));
-  Push(c1, y = cons(box(pin), y));
+  data(c1) = y = cons(box(pin), y);
 
   return Pop(c1);
 }
@@ -88,17 +88,17 @@ static void outString_spi(unsigned id, char *s) {
     platform_spi_send_recv(id, *s++);
 }
  
-static void outNum_spi(unsigned id, long n) {
-  char buf[BITS/2];
+static void outNum_spi(unsigned id, any x) {
+  char buf[numSize(x)];
 
-  bufNum(buf, n);
+  bufBig(buf, x);
   outString_spi(id, buf);
 }
 
 static void plisp_spih_prin(unsigned id, any x) {
   if (!isNil(x)) {
     if (isNum(x))
-      outNum_spi(id, unBox(x));
+      outNum_spi(id, x);
     else if (isSym(x)) {
       int i, c;
       word w;
@@ -150,6 +150,23 @@ any plisp_spi_write(any ex) {
   return y;
 }
 
-// TODO:
-// plisp_spi_readwrite(any) {}
+// Exchanges the elements of a packed array in place.
+// (spi-readwrite 'num 'arr) -> arr
+any plisp_spi_readwrite(any ex) {
+  unsigned id;
+  long i;
+  arrInfo *a;
+  any x, y;
+
+  x = cdr(ex);
+  NeedNum(ex, y = EVAL(car(x)));
+  id = unBox(y); // get id.
+  MOD_CHECK_ID(ex, spi, id);
+
+  x = cdr(x), y = EVAL(car(x));
+  a = arrCheck(ex, y);
+  for (i = 0; i < a->cnt; i++)
+    arrSet(a, i, platform_spi_send_recv(id, arrGet(a, i)));
+  return y;
+}
 
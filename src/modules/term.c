@@ -113,17 +113,17 @@ static void outString_term(char *s) {
     term_putch((u8)*s++);
 }
 
-static void outNum_term(long n) {
-  char buf[BITS/2];
+static void outNum_term(any x) {
+  char buf[numSize(x)];
 
-  bufNum(buf, n);
+  bufBig(buf, x);
   outString_term(buf);
 }
 
 static void ptermh_prin(any x) {
   if (!isNil(x)) {
     if (isNum(x))
-      outNum_term(unBox(x));
+      outNum_term(x);
     else if (isSym(x)) {
       int i, c;
       word w;
@@ -28,8 +28,7 @@ any tmr_delay(any ex) {
     // We only have 1 parameter. Assume
     // *tmr-sys-timer* and get the time
     // period.
-    NeedNum(ex, y);
-    period = (timer_data_type)unBox(y);
+    period = xWord(ex, y);
   } else {
     // Minimum 2 args required here - the
     // id and the period. Ignore the others.
@@ -37,8 +36,7 @@ any tmr_delay(any ex) {
     id = unBox(y);
     MOD_CHECK_TIMER(ex, id);
     x = cdr(x), y = EVAL(car(x));
-    NeedNum(ex, y);
-    period = unBox(y);
+    period = xWord(ex, y);
   }
   platform_timer_delay(id, period);
   return Nil;
@@ -58,7 +56,7 @@ any tmr_read(any ex) {
   }
 
   res = platform_timer_op(id, PLATFORM_TIMER_OP_READ, 0);
-  return box(res);
+  return boxWord(res);
 }
 
 // (tmr-start ['num]) -> num
@@ -75,7 +73,7 @@ any tmr_start(any ex) {
   }
 
   res = platform_timer_op(id, PLATFORM_TIMER_OP_START, 0);
-  return box(res);
+  return boxWord(res);
 }
 
 // (tmr-gettimediff 'num 'num 'num) -> num
@@ -90,15 +88,13 @@ any tmr_gettimediff(any ex) {
   MOD_CHECK_TIMER(ex, id);
 
   x = cdr(x), y = EVAL(car(x));
-  NeedNum(ex, y);
-  start = unBox(y); // get start.
+  start = xWord(ex, y); // get start.
 
   x = cdr(x), y = EVAL(car(x));
-  NeedNum(ex, y);
-  end = unBox(y); // get end.
+  end = xWord(ex, y); // get end.
 
   res = platform_timer_get_diff_us(id, start, end);
-  return box(res);
+  return boxWord(res);
 }
 
 // (tmr-getdiffnow 'num 'num) -> num
@@ -113,10 +109,9 @@ any tmr_getdiffnow(any ex) {
   MOD_CHECK_TIMER(ex, id);
 
   x = cdr(x), y = EVAL(car(x));
-  NeedNum(ex, y);
-  start = unBox(y); // get start.
+  start = xWord(ex, y); // get start.
   res = platform_timer_get_diff_crt(id, start);
-  return box(res);
+  return boxWord(res);
 }
 
 // (tmr-getmindelay ['num]) -> num
@@ -133,7 +128,7 @@ any tmr_getmindelay(any ex) {
   }
 
   res = platform_timer_op(id, PLATFORM_TIMER_OP_GET_MIN_DELAY, 0);
-  return box(res);
+  return boxWord(res);
 }
 
 // (tmr-getmaxdelay ['num]) -> num
@@ -150,7 +145,7 @@ any tmr_getmaxdelay(any ex) {
   }
 
   res = platform_timer_op(id, PLATFORM_TIMER_OP_GET_MAX_DELAY, 0);
-  return box(res);
+  return boxWord(res);
 }
 
 // (tmr-setclock 'num 'num) -> num
@@ -165,11 +160,10 @@ any tmr_setclock(any ex) {
   MOD_CHECK_TIMER(ex, id);
 
   x = cdr(x), y = EVAL(car(x));
-  NeedNum(ex, y);
-  clock = unBox(y); // get clock.
+  clock = xWord(ex, y); // get clock.
 
   clock = platform_timer_op(id, PLATFORM_TIMER_OP_SET_CLOCK, clock);
-  return box(clock);
+  return boxWord(clock);
 }
 
 // (tmr-getclock ['num]) -> num
@@ -185,7 +179,7 @@ any tmr_getclock(any ex) {
     MOD_CHECK_TIMER(ex, id);
   }
   res = platform_timer_op(id, PLATFORM_TIMER_OP_GET_CLOCK, 0);
-  return box(res);
+  return boxWord(res);
 }
 
 #ifdef HAS_TMR_MATCH_INT_PICOLISP
@@ -72,17 +72,17 @@ static void outString_uart(unsigned id, char *s) {
     platform_uart_send(id, *s++);
 }
 
-static void outNum_uart(unsigned id, long n) {
-  char buf[BITS/2];
+static void outNum_uart(unsigned id, any x) {
+  char buf[numSize(x)];
 
-  bufNum(buf, n);
+  bufBig(buf, x);
   outString_uart(id, buf);
 }
 
 static void uarth_prin(unsigned id, any x) {
   if (!isNil(x)) {
     if (isNum(x))
-      outNum_uart(id, unBox(x));
+      outNum_uart(id, x);
     else if (isSym(x)) {
       int i, c;
       word w;
@@ -138,7 +138,7 @@ any plisp_uart_write(any ex) {
 any plisp_uart_read(any ex) {
   int id, res, mode, issign;
   unsigned timer_id = PLATFORM_TIMER_SYS_ID;
-  s32 maxsize = 0, count = 0;
+  s32 maxsize = 0, count = 0, size = 0;
   char *buffer = NULL;
   char cres;
   timer_data_type timeout = PLATFORM_TIMER_INF_TIMEOUT;
@@ -156,11 +156,18 @@ any plisp_uart_read(any ex) {
       err(ex, y, "invalid max size");
     mode = UART_READ_MODE_MAXSIZE;
   } else {
-    if (equal(mkStr("*l"), y))
+    // Compare names in place, 'y' is not rooted.
+    char fmt[isSym(y) ? bufSize(y) : 1];
+
+    if (isSym(y))
+      bufString(y, fmt);
+    else
+      fmt[0] = '\0';
+    if (!strcmp(fmt, "*l"))
       mode = UART_READ_MODE_LINE;
-    else if (equal(mkStr("*n"), y))
+    else if (!strcmp(fmt, "*n"))
       mode = UART_READ_MODE_NUMBER;
-    else if (equal(mkStr("*s"), y))
+    else if (!strcmp(fmt, "*s"))
       mode = UART_READ_MODE_SPACE;
     else
       err(ex, y, "invalid format");
@@ -180,12 +187,10 @@ any plisp_uart_read(any ex) {
 
   // Read data
   while (1) {
-    buffer = realloc(buffer, 1);
     if ((res = platform_uart_recv(id, timer_id, timeout)) == -1)
       break; 
     cres = (char)res;
-    count++;
-    issign = (count == 1) && ((res == '-') || (res == '+'));
+    issign = (count == 0) && ((res == '-') || (res == '+'));
     // [TODO] this only works for lines that actually end with '\n',
     // other line endings are not supported.
     if ((cres == '\n') && (mode == UART_READ_MODE_LINE))
@@ -194,17 +199,23 @@ any plisp_uart_read(any ex) {
       break;
     if (isspace(cres) && (mode == UART_READ_MODE_SPACE))
       break;
-    buffer[count - 1] = cres;
+    if (count + 1 >= size && !(buffer = realloc(buffer, size += 32)))
+      giveup("No memory");
+    buffer[count++] = cres;
     if ((count == maxsize) && (mode == UART_READ_MODE_MAXSIZE))
       break;
   }
+  if (!buffer)
+    return mode == UART_READ_MODE_NUMBER ? Nil : mkStr("");
   buffer[count] = '\0';
 
   // Return an integer if needed
   if (mode == UART_READ_MODE_NUMBER)
-    return box(res);
+    y = box(strtol(buffer, NULL, 10));
   else
-    return mkStr(buffer);
+    y = mkStr(buffer);
+  free(buffer);
+  return y;
 }
 
 // (uart-set-buffer 'num 'num) -> Nil
@@ -273,7 +284,7 @@ any plisp_uart_getchar(any ex) {
     timer_id = unBox(y); // get timer id.
   }
   res = platform_uart_recv(id, timer_id, timeout);
-  if (res) {
+  if (res != -1) {
     cres[0] = (char)res;
     cres[1] = '\0';
     return mkStr(cres);
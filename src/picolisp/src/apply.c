@@ -4,10 +4,106 @@
 
 #include "pico.h"
 
+/* Built-ins applied to evaluated arguments */
+static any vAdd(any ex, any x, any y) {
+   if (isNil(x))
+      return Nil;
+   NeedNum(ex,x);
+   if (isNil(y))
+      return Nil;
+   NeedNum(ex,y);
+   return numAdd(x, y);
+}
+
+static any vSub(any ex, any x, any y) {
+   if (isNil(x))
+      return Nil;
+   NeedNum(ex,x);
+   if (isNil(y))
+      return Nil;
+   NeedNum(ex,y);
+   return numSub(x, y);
+}
+
+static any vMul(any ex, any x, any y) {
+   if (isNil(x))
+      return Nil;
+   NeedNum(ex,x);
+   if (isNil(y))
+      return Nil;
+   NeedNum(ex,y);
+   return numMul(x, y);
+}
+
+static any vEq(any ex __attribute__((unused)), any x, any y) {return x == y? T : Nil;}
+static any vNEq(any ex __attribute__((unused)), any x, any y) {return x == y? Nil : T;}
+static any vEqual(any ex __attribute__((unused)), any x, any y) {return equal(x,y)? T : Nil;}
+static any vNEqual(any ex __attribute__((unused)), any x, any y) {return equal(x,y)? Nil : T;}
+static any vLt(any ex __attribute__((unused)), any x, any y) {return compare(x,y) < 0? T : Nil;}
+static any vLe(any ex __attribute__((unused)), any x, any y) {return compare(x,y) <= 0? T : Nil;}
+static any vGt(any ex __attribute__((unused)), any x, any y) {return compare(x,y) > 0? T : Nil;}
+static any vGe(any ex __attribute__((unused)), any x, any y) {return compare(x,y) >= 0? T : Nil;}
+static any vCons(any ex __attribute__((unused)), any x, any y) {return cons(x,y);}
+
+static any vCar(any ex, any x, any y __attribute__((unused))) {
+   NeedLst(ex,x);
+   return car(x);
+}
+
+static any vCdr(any ex, any x, any y __attribute__((unused))) {
+   NeedLst(ex,x);
+   return cdr(x);
+}
+
+static any vNot(any ex __attribute__((unused)), any x, any y __attribute__((unused))) {
+   if (isNil(x))
+      return T;
+   val(At) = x;
+   return Nil;
+}
+
+static struct {fun sub; any (*vec)(any,any,any); int n;} Vec[] = {
+   {doAdd, vAdd, 2},
+   {doSub, vSub, 2},
+   {doMul, vMul, 2},
+   {doEq, vEq, 2},
+   {doNEq, vNEq, 2},
+   {doEqual, vEqual, 2},
+   {doNEqual, vNEqual, 2},
+   {doLt, vLt, 2},
+   {doLe, vLe, 2},
+   {doGt, vGt, 2},
+   {doGe, vGe, 2},
+   {doCons, vCons, 2},
+   {doCar, vCar, 1},
+   {doCdr, vCdr, 1},
+   {doNot, vNot, 1}
+};
+
+/* Vector entry of a built-in for 'n' arguments, or -1 */
+static int vector(any foo, int n) {
+   static fun last;
+   static int idx = -1;
+   fun f = subrFun(foo);
+   int i;
+
+   if (f != last) {
+      last = f,  idx = -1;
+      for (i = 0;  i < (int)(sizeof(Vec)/sizeof(Vec[0]));  ++i)
+         if (Vec[i].sub == f) {
+            idx = i;
+            break;
+         }
+   }
+   return idx >= 0 && Vec[idx].n == n? idx : -1;
+}
+
 any apply(any ex, any foo, bool cf, int n, cell *p) {
+   int i;
+
+   NeedStack(ex);
    while (!isNum(foo)) {
       if (isCell(foo)) {
-         int i;
          any x = car(foo);
          struct {  // bindFrame
             struct bindFrame *link;
@@ -58,7 +154,6 @@ any apply(any ex, any foo, bool cf, int n, cell *p) {
          NeedSymb(ex,o);
          TheCls = NULL,  TheKey = foo;
          if (expr = method(o)) {
-            int i;
             any cls = Env.cls, key = Env.key;
             struct {  // bindFrame
                struct bindFrame *link;
@@ -121,6 +216,10 @@ any apply(any ex, any foo, bool cf, int n, cell *p) {
          undefined(foo,ex);
       foo = val(foo);
    }
+   if ((i = vector(foo, n)) >= 0)
+      return Vec[i].vec(ex,
+         cf? car(data(p[0])) : data(p[0]),
+         n < 2? Nil : cf? car(data(p[1])) : data(p[1]) );
    if (--n < 0)
       cdr(ApplyBody) = Nil;
    else {
@@ -128,7 +227,7 @@ any apply(any ex, any foo, bool cf, int n, cell *p) {
       val(caar(x)) = cf? car(data(p[n])) : data(p[n]);
       while (--n >= 0) {
          if (!isCell(cdr(x)))
-            cdr(x) = cons(cons(consSym(Nil,0), car(x)), Nil);
+            cdr(x) = consHeap(consHeap(consSym(Nil,0), car(x)), Nil);
          x = cdr(x);
          val(caar(x)) = cf? car(data(p[n])) : data(p[n]);
       }
@@ -538,10 +637,9 @@ any doCnt(any ex) {
 // (sum 'fun 'lst ..) -> num
 any doSum(any ex) {
    any x = cdr(ex);
-   int res;
-   cell foo;
+   cell res, foo;
 
-   res = 0;
+   Push(res, Zero);
    Push(foo, EVAL(car(x)));
    if (isCell(x = cdr(x))) {
       int i, n = 0;
@@ -552,13 +650,13 @@ any doSum(any ex) {
       while (isCell(x = cdr(x)));
       while (isCell(data(c[0]))) {
          if (isNum(x = apply(ex, data(foo), YES, n, c)))
-            res += unBox(x);
+            data(res) = numAdd(data(res), x);
          for (i = 0; i < n; ++i)
             data(c[i]) = cdr(data(c[i]));
       }
    }
-   drop(foo);
-   return box(res);
+   drop(res);
+   return data(res);
 }
 
 // (maxi 'fun 'lst ..) -> any
@@ -0,0 +1,198 @@
+/* Packed numeric arrays
+ *
+ * An array is a header cell (Arr . idx) in the heap. 'idx' is the slot of
+ * its malloc'ed buffer in the registry kept by gc.c, and the buffer is
+ * freed by the first collection which finds the header unreachable.
+ * Indexes are 1-based as for lists, stored values are truncated to the
+ * element type, and 'arr-write' outputs the elements in native byte order.
+ */
+
+#include "pico.h"
+
+static char *TypeNames[] = {"u8", "s8", "u16", "s16", "u32", "s32"};
+
+/* Check for an array, the result is valid until the next consArr() */
+arrInfo *arrCheck(any ex, any x) {
+   long i;
+
+   if (!isCell(x)  ||  car(x) != Arr  ||  !isShort(cdr(x))  ||
+         (i = unBox(cdr(x))) < 0  ||  i >= ArrCnt  ||  Arrs[i].hdr != x)
+      err(ex, x, "Array expected");
+   return Arrs + i;
+}
+
+long arrGet(arrInfo *a, long i) {
+   switch (a->type) {
+   case ARR_U8:
+      return ((uint8_t*)a->buf)[i];
+   case ARR_S8:
+      return ((int8_t*)a->buf)[i];
+   case ARR_U16:
+      return ((uint16_t*)a->buf)[i];
+   case ARR_S16:
+      return ((int16_t*)a->buf)[i];
+   case ARR_U32:
+      return (long)((uint32_t*)a->buf)[i];
+   default:
+      return ((int32_t*)a->buf)[i];
+   }
+}
+
+void arrSet(arrInfo *a, long i, long n) {
+   switch (a->type) {
+   case ARR_U8:
+   case ARR_S8:
+      ((uint8_t*)a->buf)[i] = (uint8_t)n;
+      break;
+   case ARR_U16:
+   case ARR_S16:
+      ((uint16_t*)a->buf)[i] = (uint16_t)n;
+      break;
+   default:
+      ((uint32_t*)a->buf)[i] = (uint32_t)n;
+   }
+}
+
+/* Boxed element, u32 may not fit into a long */
+static any arrNum(arrInfo *a, long i) {
+   return a->type == ARR_U32? boxWord(((uint32_t*)a->buf)[i]) : boxLong(arrGet(a,i));
+}
+
+static int arrType(any ex, any x) {
+   int i;
+
+   NeedSymb(ex,x);
+   {
+      char nm[bufSize(x)];
+
+      bufString(x, nm);
+      for (i = 0;  i < (int)(sizeof(TypeNames)/sizeof(char*));  ++i)
+         if (strcmp(nm, TypeNames[i]) == 0)
+            return i;
+   }
+   err(ex, x, "Bad array type");
+}
+
+/* Evaluate a 1-based index into 'x' */
+static long arrIdx(any ex, any x, any y) {
+   long i;
+
+   y = EVAL(car(y));
+   if ((i = xNum(ex,y)) < 1  ||  i > arrCheck(ex,x)->cnt)
+      err(ex, y, "Bad index");
+   return i - 1;
+}
+
+// (arr-new 'sym 'cnt|lst) -> arr
+any doArrNew(any ex) {
+   any x, y;
+   int t;
+   long i, n;
+   arrInfo *a;
+   cell c1;
+
+   x = cdr(ex),  t = arrType(ex, EVAL(car(x)));
+   x = cdr(x),  Push(c1, y = EVAL(car(x)));
+   if (isNum(y)) {
+      if ((n = xNum(ex,y)) < 0)
+         argError(ex,y);
+      drop(c1);
+      return consArr(t, n);
+   }
+   NeedLst(ex,y);
+   for (n = 0;  isCell(y);  ++n, y = cdr(y))
+      NeedNum(ex,car(y));
+   x = consArr(t, n);
+   for (a = arrCheck(ex,x), i = 0, y = data(c1);  i < n;  ++i, y = cdr(y))
+      arrSet(a, i, (long)xWord(ex, car(y)));
+   drop(c1);
+   return x;
+}
+
+// (arr-len 'arr) -> cnt
+any doArrLen(any ex) {
+   return box(arrCheck(ex, EVAL(cadr(ex)))->cnt);
+}
+
+// (arr-get 'arr 'cnt) -> num
+any doArrGet(any ex) {
+   any x;
+   long i;
+   cell c1;
+
+   x = cdr(ex),  Push(c1, EVAL(car(x)));
+   i = arrIdx(ex, data(c1), cdr(x));
+   x = arrNum(arrCheck(ex, data(c1)), i);
+   drop(c1);
+   return x;
+}
+
+// (arr-set 'arr 'cnt 'num) -> num
+any doArrSet(any ex) {
+   any x, y;
+   long i;
+   cell c1;
+
+   x = cdr(ex),  Push(c1, EVAL(car(x)));
+   x = cdr(x),  i = arrIdx(ex, data(c1), x);
+   x = cdr(x),  y = EVAL(car(x));
+   arrSet(arrCheck(ex, data(c1)), i, (long)xWord(ex,y));
+   drop(c1);
+   return y;
+}
+
+// (arr-slice 'arr 'cnt1 'cnt2) -> arr
+any doArrSlice(any ex) {
+   any x;
+   long i, j;
+   arrInfo *a;
+   cell c1;
+
+   x = cdr(ex),  Push(c1, EVAL(car(x)));
+   x = cdr(x),  i = arrIdx(ex, data(c1), x);
+   x = cdr(x),  j = arrIdx(ex, data(c1), x);
+   if (j < i)
+      j = i - 1;
+   x = consArr(arrCheck(ex, data(c1))->type, j - i + 1);
+   a = arrCheck(ex, data(c1));
+   memcpy(arrCheck(ex,x)->buf, (char*)a->buf + (i << a->type/2), (j - i + 1) << a->type/2);
+   drop(c1);
+   return x;
+}
+
+/* Elements of the array 'x' as a list */
+any arrList(any ex, any x) {
+   long i;
+   arrInfo *a;
+   cell c1, c2;
+
+   Push(c1, x);
+   Push(c2, Nil);
+   for (a = arrCheck(ex,x), i = a->cnt;  --i >= 0;)
+      data(c2) = cons(arrNum(a,i), data(c2));
+   x = data(c2);
+   drop(c1);
+   return x;
+}
+
+// (arr-list 'arr) -> lst
+any doArrList(any ex) {
+   return arrList(ex, EVAL(cadr(ex)));
+}
+
+// (arr-write 'arr) -> arr
+any doArrWrite(any ex) {
+   arrInfo *a;
+   long i, n;
+   cell c1;
+
+   Push(c1, EVAL(cadr(ex)));
+   a = arrCheck(ex, data(c1));
+   n = a->cnt << a->type/2;
+   if (Env.put == putStdout)
+      fwrite(a->buf, 1, n, OutFile);
+   else
+      for (i = 0;  i < n;  ++i)
+         Env.put(((byte*)a->buf)[i]);
+   return Pop(c1);
+}
@@ -22,6 +22,7 @@ static void redefine(any ex, any s, any x) {
    if (!isNil(val(s))  &&  s != val(s)  &&  !equal(x,val(s)))
       redefMsg(s,NULL);
    val(s) = x;
+   ArenaRef(s, x);
 }
 
 // (quote . any) -> any
@@ -193,6 +194,8 @@ any doDef(any ex) {
       if (!isNil(y = val(data(c1)))  &&  y != data(c1)  &&  !equal(data(c2), y))
          redefMsg(data(c1),NULL);
       val(data(c1)) = data(c2);
+      ArenaRef(data(c1), data(c2));
+      flushMeth();
    }
    else {
       x = cdr(x),  Push(c3, EVAL(car(x)));
@@ -206,6 +209,8 @@ any doDef(any ex) {
 // (de sym . any) -> sym
 any doDe(any ex) {
    redefine(ex, cadr(ex), cddr(ex));
+   if (!isNil(val(Comp)))
+      compFun(cadr(ex));
    return cadr(ex);
 }
 
@@ -241,18 +246,21 @@ any doDm(any ex) {
       if (caar(y) == msg) {
          if (!equal(cdr(x), cdar(y)))
             redefMsg(msg,cls);
-         cdar(y) = cdr(x);
+         cdar(y) = cdr(x),  ArenaRef(car(y), cdr(x));
+         flushMeth();
          return msg;
       }
    if (!isCell(car(x)))
       val(cls) = cons(x, val(cls));
    else
       val(cls) = cons(cons(msg, cdr(x)), val(cls));
+   ArenaRef(cls, val(cls));
+   flushMeth();
    return msg;
 }
 
-/* Evaluate method invocation */
-static any evMethod(any o, any expr, any x) {
+/* Evaluate method invocation with any parameter list */
+static any evMethVar(any o, any expr, any x) {
    any y = car(expr);
    any cls = TheCls, key = TheKey;
    struct {  // bindFrame
@@ -321,7 +329,66 @@ static any evMethod(any o, any expr, any x) {
    return x;
 }
 
-any method(any x) {
+/* Fixed-arity methods get a frame of constant size */
+static any evMethod(any o, any expr, any x) {
+   any y = car(expr);
+   any cls = TheCls, key = TheKey;
+   int n;
+   struct {  // bindFrame
+      struct bindFrame *link;
+      int i, cnt;
+      struct {any sym; any val;} bnd[6];
+   } f;
+
+   if (!isFixed(y))
+      return evMethVar(o, expr, x);
+   f.link = Env.bind,  Env.bind = (bindFrame*)&f;
+   f.i = 1;
+   f.cnt = 1,  f.bnd[0].sym = At,  f.bnd[0].val = val(At);
+   while (isCell(y)) {
+      f.bnd[f.cnt].sym = car(y);
+      f.bnd[f.cnt].val = EVAL(car(x));
+      ++f.cnt, x = cdr(x), y = cdr(y);
+   }
+   f.bnd[f.cnt].sym = This,  f.bnd[f.cnt++].val = o;
+   n = f.cnt;
+   do {
+      x = val(f.bnd[--n].sym);
+      val(f.bnd[n].sym) = f.bnd[n].val;
+      f.bnd[n].val = x;
+   } while (n);
+   f.i = 0;
+   if (cls == Env.cls  &&  key == Env.key)
+      x = prog(cdr(expr));
+   else {
+      y = cls,  cls = Env.cls;  Env.cls = y;
+      y = key,  key = Env.key;  Env.key = y;
+      x = prog(cdr(expr));
+      Env.cls = cls,  Env.key = key;
+   }
+   while (--f.cnt >= 0)
+      val(f.bnd[f.cnt].sym) = f.bnd[f.cnt].val;
+   Env.bind = f.link;
+   return x;
+}
+
+/* Method cache, keyed on the class list of the receiver and the message.
+ * Entries of older generations are stale, so a flush is a single increment. */
+static struct {any cls, key, fun, sup; word gen;} MethCache[1 << METH_CACHE];
+static word MethGen = 1;
+
+void flushMeth(void) {
+   if (!++MethGen)
+      memset(MethCache, 0, sizeof(MethCache)),  MethGen = 1;
+}
+
+/* Flush the method cache if 'x' may be a class or part of a class list */
+void flushClass(any x) {
+   if (!isSymb(x)  ||  firstByte(x) == '+')
+      flushMeth();
+}
+
+static any lookup(any x) {
    any y, z;
 
    if (isCell(y = val(x))) {
@@ -332,13 +399,31 @@ any method(any x) {
             return NULL;
       }
       do
-         if (x = method(car(TheCls = y)))
+         if (x = lookup(car(TheCls = y)))
             return x;
       while (isCell(y = cdr(y)));
    }
    return NULL;
 }
 
+any method(any x) {
+   int i;
+   any y;
+
+   if (TheCls  ||  !isCell(y = val(x)))
+      return lookup(x);
+   i = (word)(num(y) ^ num(TheKey)) * HASH_MUL >> (BITS - METH_CACHE);
+   if (MethCache[i].cls == y  &&  MethCache[i].key == TheKey  &&  MethCache[i].gen == MethGen) {
+      TheCls = MethCache[i].sup;
+      return MethCache[i].fun;
+   }
+   x = lookup(x);
+   MethCache[i].cls = y,  MethCache[i].key = TheKey;
+   MethCache[i].fun = x,  MethCache[i].sup = TheCls;
+   MethCache[i].gen = MethGen;
+   return x;
+}
+
 // (box 'any) -> sym
 any doBox(any x) {
    x = cdr(x);
@@ -437,7 +522,7 @@ any doMethod(any ex) {
 
    x = cdr(ex),  y = EVAL(car(x));
    x = cdr(x),  x = EVAL(car(x));
-   TheKey = y;
+   TheKey = y,  TheCls = NULL;
    return method(x)? : Nil;
 }
 
@@ -640,7 +725,7 @@ any doJob(any ex) {
    }
    x = prog(cdr(x));
    for (f.cnt = 0, y = Pop(c1);  isCell(y);  ++f.cnt, y = cdr(y)) {
-      cdar(y) = val(caar(y));
+      cdar(y) = val(caar(y)),  ArenaRef(car(y), cdar(y));
       val(caar(y)) = f.bnd[f.cnt].val;
    }
    Env.bind = f.link;
@@ -977,7 +1062,7 @@ any doState(any ex) {
       if (car(y) == T || memq(val(data(c1)), car(y))) {
          y = cdr(y);
          if (!isNil(a = EVAL(car(y)))) {
-            val(At) = val(data(c1)) = a;
+            val(At) = val(data(c1)) = a,  ArenaRef(data(c1), a);
             drop(c1);
             return prog(cdr(y));
          }
@@ -1045,18 +1130,19 @@ any doLoop(any ex) {
 // (do 'flg|num ['any | (NIL 'any . prg) | (T 'any . prg) ..]) -> any
 any doDo(any x) {
    any f, y, z, a;
+   long n = 0;
 
    x = cdr(x);
    if (isNil(f = EVAL(car(x))))
       return Nil;
-   if (isNum(f) && num(f) < 0)
+   if (isNum(f) && (n = xNum(x,f)) < 0)
       return Nil;
    x = cdr(x),  z = Nil;
    for (;;) {
       if (isNum(f)) {
-         if (f == Zero)
+         if (n == 0)
             return z;
-         f = (any)(num(f) - 4);
+         --n;
       }
       y = x;
       do {
@@ -1088,6 +1174,7 @@ any doDo(any x) {
 // (at '(cnt1 . cnt2|NIL) . prg) -> any
 any doAt(any ex) {
    any x;
+   cell c1;
 
    x = cdr(ex),  x = EVAL(car(x));
    NeedPair(ex,x);
@@ -1095,7 +1182,10 @@ any doAt(any ex) {
       return Nil;
    NeedNum(ex,car(x));
    NeedNum(ex,cdr(x));
-   if (num(car(x) = (any)(num(car(x)) + 4)) < num(cdr(x)))
+   Push(c1, x);
+   car(x) = numInc(car(x));
+   drop(c1);
+   if (numCmp(car(x), cdr(x)) < 0)
       return Nil;
    car(x) = Zero;
    return prog(cddr(ex));
@@ -1136,8 +1226,8 @@ any doFor(any x) {
       body = x = cdr(x);
       for (;;) {
          if (isNum(data(c1))) {
-            val(f.bnd[0].sym) = (any)(num(val(f.bnd[0].sym)) + 4);
-            if (num(val(f.bnd[0].sym)) > num(data(c1)))
+            val(f.bnd[0].sym) = numInc(val(f.bnd[0].sym));
+            if (numCmp(val(f.bnd[0].sym), data(c1)) > 0)
                break;
          }
          else {
@@ -1148,7 +1238,7 @@ any doFor(any x) {
                data(c1) = Nil;
          }
          if (f.cnt == 2)
-            val(f.bnd[1].sym) = (any)(num(val(f.bnd[1].sym)) + 4);
+            val(f.bnd[1].sym) = numInc(val(f.bnd[1].sym));
          do {
             if (!isNum(y = car(x))) {
                if (isSym(y))
@@ -1205,12 +1295,12 @@ any doFor(any x) {
    body = x = cdr(x);
    for (;;) {
       if (f.cnt == 2)
-         val(f.bnd[1].sym) = (any)(num(val(f.bnd[1].sym)) + 4);
+         val(f.bnd[1].sym) = numInc(val(f.bnd[1].sym));
       if (isNil(a = EVAL(cond)))
          break;
       val(At) = a;
       if (f.cnt == 2)
-         val(f.bnd[1].sym) = (any)(num(val(f.bnd[1].sym)) + 4);
+         val(f.bnd[1].sym) = numInc(val(f.bnd[1].sym));
       do {
          if (!isNum(data(c1) = car(x))) {
             if (isSym(data(c1)))
@@ -1257,7 +1347,10 @@ any doCatch(any x) {
    x = cdr(x),  f.tag = EVAL(car(x)),  f.fin = Zero;
    f.link = CatchPtr,  CatchPtr = &f;
    f.env = Env;
-   y = setjmp(f.rst)? Thrown : prog(cdr(x));
+   if (setjmp(f.rst))
+      y = Thrown,  Thrown = Nil;
+   else
+      y = prog(cdr(x));
    CatchPtr = f.link;
    return y;
 }
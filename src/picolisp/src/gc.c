@@ -3,52 +3,198 @@
  */
 
 #include "pico.h"
+#include "platform.h"
 
-/* Mark data */
+/* Back-link tags for the pointer reversal in mark() */
+#define MARK_C1 0  // Cell: car reversed
+#define MARK_C2 2  // Cell: cdr reversed
+#define MARK_P1 4  // Symbol or property cell: cdr reversed
+#define MARK_P2 6  // Symbol or property cell: car reversed
+
+static heap *MarkH, *MarkH2;  // Heap blocks of the last two marked cells
+static heap **HeapTab;  // Heap blocks sorted by address
+static int HeapCnt;
+static word HeapSpan;  // Address range covered by HeapTab
+static cell *Arena;  // Reserved arena block
+static word ArenaMarks[ARENA/BITS];
+static word ArenaFwd[ARENA/BITS];  // Arena cells already moved to the heap
+static any ArenaRefs;  // Objects outside of a scope referring into it
+static any ArenaFin;   // Unwind handler of 'with-arena'
+static any Pending;    // Moved arena cells not yet scanned
+
+/* Index of the heap block holding 'x', or of the first one above it */
+static int heapIdx(any x) {
+   int lo = 0, hi = HeapCnt, i;
+
+   while (lo < hi) {
+      i = (lo + hi) / 2;
+      if ((ptr)x < (ptr)HeapTab[i]->cells + sizeof(HeapTab[i]->cells))
+         hi = i;
+      else
+         lo = i + 1;
+   }
+   return lo;
+}
+
+/* Recompute the address range covered by HeapTab */
+static void heapSpan(void) {
+   HeapSpan = (ptr)(HeapTab[HeapCnt-1] + 1) - (ptr)HeapTab[0]->cells;
+}
+
+/* Enter a new heap block into the address table */
+void heapLink(heap *h) {
+   int i = heapIdx(h->cells);
+
+   HeapTab = alloc(HeapTab, (HeapCnt + 1) * sizeof(heap*));
+   memmove(HeapTab + i + 1, HeapTab + i, (HeapCnt++ - i) * sizeof(heap*));
+   HeapTab[i] = h;
+   heapSpan();
+}
+
+/* Remove a heap block from the address table */
+static void heapUnlink(heap *h) {
+   int i = heapIdx(h->cells);
+
+   memmove(HeapTab + i, HeapTab + i + 1, (--HeapCnt - i) * sizeof(heap*));
+   heapSpan();
+   MarkH = MarkH2 = Heaps;
+}
+
+/* Mark word and bit of a cell, NULL if outside the heap */
+static word *markWord(any x, word *m) {
+   heap *h;
+   int j;
+   word i, *w;
+
+   if ((i = (ptr)x - (ptr)(h = MarkH)->cells) < sizeof(h->cells))
+      w = h->marks;
+   else {
+      if ((i = (ptr)x - (ptr)(h = MarkH2)->cells) < sizeof(h->cells)  ||
+            ((i = (ptr)x - (ptr)HeapTab[0]->cells) < HeapSpan  &&  (j = heapIdx(x)) < HeapCnt  &&
+               (i = (ptr)x - (ptr)(h = HeapTab[j])->cells) < sizeof(h->cells) ) )
+         MarkH2 = MarkH,  w = (MarkH = h)->marks;
+      else if (Arena  &&  (i = (ptr)x - (ptr)Arena) < ARENA*sizeof(cell))
+         w = ArenaMarks;
+      else
+         return NULL;
+   }
+   i /= sizeof(cell);
+   *m = (word)1 << i%BITS;
+   return w + i/BITS;
+}
+
+/* Set the mark bit of a cell, return YES if it was already set */
+static bool marked(any x) {
+   word m, *w;
+
+   if (!(w = markWord(x, &m))  ||  *w & m)
+      return YES;
+   *w |= m;
+   return NO;
+}
+
+/* Mark data (Deutsch-Schorr-Waite, constant stack) */
 static void mark(any x) {
-   while (isCell(x)) {
-      if (!(num(cdr(x)) & 1))
-         return;
-      *(long*)&cdr(x) &= ~1;
-      mark(car(x)),  x = cdr(x);
-   }
-   if (!isNum(x)  &&  num(val(x)) & 1) {
-      *(long*)&val(x) &= ~1;
-      mark(val(x)),  x = tail(x);
-      while (isCell(x)) {
-         if (!(num(cdr(x)) & 1))
+   any p, y;
+   word t = 0;
+   bool chain = NO;
+
+   for (;;) {
+      if (isCell(x)) {
+         if (!marked(x)) {
+            if (chain)
+               y = cdr(x),  cdr(x) = (any)t,  t = num(x) | MARK_P1;
+            else
+               y = car(x),  car(x) = (any)t,  t = num(x) | MARK_C1;
+            x = y,  chain = NO;
+            continue;
+         }
+      }
+      else if (chain) {
+         if (!isTxt(x))
+            for (y = x;  !marked((any)((ptr)y - PICOLISP_WORD))  &&  !isNum(y = val(y)););
+      }
+      else if (isBig(x)) {
+         for (y = x;  !marked(p = bigCell(y))  &&  isBig(y = cdr(p)););
+      }
+      else if (!isNum(x)  &&  !marked(p = (any)((ptr)x - PICOLISP_WORD))) {
+         y = val(x),  val(x) = (any)t,  t = num(p) | MARK_P1;
+         x = y;
+         continue;
+      }
+      for (;;) {
+         if (!t)
             return;
-         *(long*)&cdr(x) &= ~1;
-         mark(cdr(x)),  x = car(x);
+         p = (any)(t & ~6);
+         if ((t & 6) == MARK_C1) {
+            y = car(p),  car(p) = x,  x = cdr(p),  cdr(p) = y;
+            t = num(p) | MARK_C2,  chain = NO;
+            break;
+         }
+         if ((t & 6) == MARK_P1) {
+            y = cdr(p),  cdr(p) = x,  x = car(p),  car(p) = y;
+            t = num(p) | MARK_P2,  chain = YES;
+            break;
+         }
+         if ((t & 6) == MARK_C2)
+            y = cdr(p),  cdr(p) = x,  x = p;
+         else
+            y = car(p),  car(p) = x,  x = (num(y) & 6) == MARK_P2? p : symPtr(p);
+         t = num(y);
       }
-      if (!isTxt(x))
-         do {
-            if (!(num(val(x)) & 1))
-               return;
-            *(long*)&val(x) &= ~1;
-         } while (!isNum(x = val(x)));
    }
 }
 
-/* Garbage collector */
-static void gc(long c) {
+arrInfo *Arrs;  // Packed array registry
+int ArrCnt;
+static size_t ArrBytes;  // Array bytes allocated since the last marking
+
+static heap *SweepH;  // Heap block being swept lazily
+static long SweepW;   // Next mark word to sweep in SweepH
+static long GcStep = GC_STEP;
+static long HeapLow = CELLS, HeapHigh = 2*CELLS;  // Free cells kept after marking
+static timer_data_type GcLast, GcWorst, GcTime;
+
+/* Torture mode: collect completely on every allocation */
+#ifdef PICOLISP_GC_TORTURE
+#define GC_TORTURE 1
+#else
+#define GC_TORTURE 0
+#endif
+
+/* Free the buffers of arrays with unmarked headers */
+static void sweepArrs(void) {
+   arrInfo *a;
+   word m, *w;
+
+   for (a = Arrs;  a < Arrs + ArrCnt;  ++a)
+      if (a->hdr  &&  (w = markWord(a->hdr, &m))  &&  !(*w & m))
+         free(a->buf),  a->hdr = NULL;
+   ArrBytes = 0;
+}
+
+/* Mark all reachable cells, return the number of free cells */
+static long markAll(void) {
    any p;
    heap *h;
-   int i;
+   long i, n;
 
    h = Heaps;
-   do {
-      p = h->cells + CELLS-1;
-      do
-         *(long*)&cdr(p) |= 1;
-      while (--p >= h->cells);
-   } while (h = h->next);
-   /* Mark */
+   do
+      memset(h->marks, 0, sizeof(h->marks));
+   while (h = h->next);
+   memset(ArenaMarks, 0, sizeof(ArenaMarks));
+   flushMeth(),  flushProp();
+   MarkH = MarkH2 = Heaps;
    mark(Nil+1);
+   mark(Exec);
+   mark(Arr);
    mark(Intern[0]),  mark(Intern[1]);
    mark(Transient[0]), mark(Transient[1]);
    mark(ApplyArgs),  mark(ApplyBody);
    mark(Reloc);
+   if (ArenaFin)
+      mark(ArenaFin),  mark(ArenaRefs);
    for (p = Env.stack; p; p = cdr(p))
       mark(car(p));
    for (p = (any)Env.bind;  p;  p = (any)((bindFrame*)p)->link)
@@ -61,61 +207,222 @@ static void gc(long c) {
          mark(((catchFrame*)p)->tag);
       mark(((catchFrame*)p)->fin);
    }
-   /* Sweep */
+   sweepArrs();
    Avail = NULL;
-   h = Heaps;
-   if (c) {
-      do {
-         p = h->cells + CELLS-1;
-         do
-            if (num(p->cdr) & 1)
-               Free(p),  --c;
-         while (--p >= h->cells);
-      } while (h = h->next);
-      while (c >= 0)
-         heapAlloc(),  c -= CELLS;
+   n = 0,  h = Heaps;
+   do
+      for (i = CELLS/BITS;  --i >= 0;)
+         n += BITS - __builtin_popcountl(h->marks[i]);
+   while (h = h->next);
+   ++GcStat.gcs;
+   GcStat.freed += n - (GcStat.base - GcStat.cells);
+   GcStat.base = GcStat.cells + n;
+   return n;
+}
+
+/* Free the unmarked cells of one mark word */
+static void sweepWord(heap *h, long i) {
+   int j;
+   word m = ~h->marks[i];
+
+   while (m) {
+      j = BITS-1 - __builtin_clzl(m);
+      m &= ~((word)1 << j);
+      Free(h->cells + i*BITS + j);
    }
-   else {
-      heap **hp = &Heaps;
-      cell *av;
-
-      do {
-         c = CELLS;
-         av = Avail;
-         p = h->cells + CELLS-1;
-         do
-            if (num(p->cdr) & 1)
-               Free(p),  --c;
-         while (--p >= h->cells);
-         if (c)
-            hp = &h->next,  h = h->next;
-         else
-            Avail = av,  h = h->next,  free(*hp),  *hp = h;
-      } while (h);
+}
+
+/* Sweep up to 'n' cells */
+static void sweep(long n) {
+   long i = SweepW;
+
+   for (;;) {
+      do
+         sweepWord(SweepH, i);
+      while (--i >= 0  &&  (n -= BITS) > 0);
+      if (i >= 0) {
+         SweepW = i;
+         return;
+      }
+      if (!(SweepH = SweepH->next))
+         return;
+      i = CELLS/BITS - 1;
+      if (n <= 0) {
+         SweepW = i;
+         return;
+      }
    }
 }
 
+static void gcTime(timer_data_type t) {
+   GcTime += GcLast = platform_timer_read_sys() - t;
+   if (GcLast > GcWorst)
+      GcWorst = GcLast;
+}
+
+/* Release empty heap blocks while at least 'm' cells stay free */
+static long release(long n, long m) {
+   heap *h, **hp = &Heaps;
+   size_t i;
+
+   while (h = *hp) {
+      for (i = 0;  i < CELLS/BITS  &&  !h->marks[i];  ++i);
+      if (i == CELLS/BITS  &&  n - (long)CELLS >= m) {
+         *hp = h->next,  heapUnlink(h),  free(h);
+         n -= CELLS,  ++GcStat.del,  GcStat.base -= CELLS;
+      }
+      else
+         hp = &h->next;
+   }
+   return n;
+}
+
+/* Garbage collector (lazy sweep) */
+static void gc(void) {
+   long n;
+   timer_data_type t = platform_timer_read_sys();
+
+   if (GC_TORTURE)
+      SweepH = NULL;
+   do {
+      if (!SweepH) {
+         n = markAll();
+         if (n - (long)CELLS >= HeapHigh)
+            n = release(n, HeapHigh);
+         SweepH = Heaps,  SweepW = CELLS/BITS - 1;
+         for (n = HeapLow - n;  n >= 0;  n -= CELLS)
+            heapAlloc();
+      }
+      do
+         sweep(GcStep);
+      while (GC_TORTURE  &&  SweepH);
+   } while (!Avail);
+   gcTime(t);
+}
+
+/* Garbage collector (full cycle) */
+static void gcFull(long c) {
+   heap *h;
+   long i, n;
+   timer_data_type t = platform_timer_read_sys();
+
+   n = markAll();
+   SweepH = NULL;
+   if (!c)
+      release(n, 0);
+   h = Heaps;
+   do
+      for (i = CELLS/BITS;  --i >= 0;)
+         sweepWord(h, i);
+   while (h = h->next);
+   if (c)
+      for (c -= n;  c >= 0;  c -= CELLS)
+         heapAlloc();
+   gcTime(t);
+}
+
 // (gc ['num]) -> num | NIL
-any doGc(any x) {
-   x = cdr(x);
-   gc(isNum(x = EVAL(car(x)))? CELLS*unBox(x) : CELLS);
+any doGc(any ex) {
+   any x = cdr(ex);
+
+   gcFull(isNum(x = EVAL(car(x)))? CELLS*xNum(ex,x) : CELLS);
+   return x;
+}
+
+// (heap-policy ['num1 ['num2]]) -> (num1 . num2)
+any doHeapPolicy(any ex) {
+   any x;
+   long lo = HeapLow / CELLS,  hi = HeapHigh / CELLS;
+
+   if (isCell(x = cdr(ex))) {
+      lo = evNum(ex,x);
+      if (isCell(x = cdr(x)))
+         hi = evNum(ex,x);
+      if (lo < 0  ||  hi <= lo)
+         err(ex, NULL, "Bad heap policy");
+      HeapLow = lo * CELLS,  HeapHigh = hi * CELLS;
+   }
+   return cons(box(lo), box(hi));
+}
+
+// (gc-step ['cnt]) -> cnt
+any doGcStep(any ex) {
+   any x;
+
+   x = cdr(ex);
+   if (isCell(x)) {
+      x = EVAL(car(x));
+      if ((GcStep = xNum(ex,x)) <= 0)
+         argError(ex,x);
+   }
+   return box(GcStep);
+}
+
+static any stat(char *s, long n, any x) {
+   cell c1;
+
+   Push(c1, x);
+   x = cons(cons(intern(mkSym((byte*)s), Intern), box(n)), x);
+   drop(c1);
    return x;
 }
 
+// (gc-stats) -> lst
+any doGcStats(any ex __attribute__((unused))) {
+   any x;
+
+   x = stat("worst", GcWorst, Nil);
+   x = stat("pause", GcLast, x);
+   x = stat("time", GcTime, x);
+   x = stat("freed", GcStat.del, x);
+   x = stat("added", GcStat.add, x);
+   x = stat("free", GcStat.base - GcStat.cells, x);
+   x = stat("reclaimed", GcStat.freed, x);
+   x = stat("collections", GcStat.gcs, x);
+   return stat("allocated", GcStat.cells, x);
+}
+
 /* Construct a cell */
 any cons(any x, any y) {
    cell *p;
 
-   if (!(p = Avail)) {
+   if (p = Env.arena) {
+      if (p == Arena + ARENA)
+         err(NULL, NULL, "Arena full");
+      Env.arena = p + 1;
+      p->car = x;
+      p->cdr = y;
+      return p;
+   }
+   if (GC_TORTURE  ||  !(p = Avail)) {
+      cell c1, c2;
+
+      Push(c1,x);
+      Push(c2,y);
+      gc();
+      drop(c1);
+      p = Avail;
+   }
+   Avail = p->car,  ++GcStat.cells;
+   p->car = x;
+   p->cdr = y;
+   return p;
+}
+
+/* Construct a cell outside of an arena */
+any consHeap(any x, any y) {
+   cell *p;
+
+   if (GC_TORTURE  ||  !(p = Avail)) {
       cell c1, c2;
 
       Push(c1,x);
       Push(c2,y);
-      gc(CELLS);
+      gc();
       drop(c1);
       p = Avail;
    }
-   Avail = p->car;
+   Avail = p->car,  ++GcStat.cells;
    p->car = x;
    p->cdr = y;
    return p;
@@ -125,22 +432,23 @@ any cons(any x, any y) {
 any consSym(any val, word w) {
    cell *p;
 
-   if (!(p = Avail)) {
+   if (GC_TORTURE  ||  !(p = Avail)) {
       cell c1;
 
       if (!val)
-         gc(CELLS);
+         gc();
       else {
          Push(c1,val);
-         gc(CELLS);
+         gc();
          drop(c1);
       }
       p = Avail;
    }
-   Avail = p->car;
+   Avail = p->car,  ++GcStat.cells;
    p = symPtr(p);
    val(p) = val ?: p;
    tail(p) = txt(w);
+   ArenaRef(p, val(p));
    return p;
 }
 
@@ -148,13 +456,167 @@ any consSym(any val, word w) {
 any consName(word w, any n) {
    cell *p;
 
-   if (!(p = Avail)) {
-      gc(CELLS);
+   if (GC_TORTURE  ||  !(p = Avail)) {
+      gc();
       p = Avail;
    }
-   Avail = p->car;
+   Avail = p->car,  ++GcStat.cells;
    p = symPtr(p);
    val(p) = n;
    tail(p) = (any)w;
    return p;
 }
+
+/* Construct a bignum cell */
+any consNum(word w, any n) {
+   cell *p;
+
+   if (GC_TORTURE  ||  !(p = Avail)) {
+      cell c1;
+
+      Push(c1,n);
+      gc();
+      drop(c1);
+      p = Avail;
+   }
+   Avail = p->car,  ++GcStat.cells;
+   p->car = (any)w;
+   p->cdr = n;
+   return (any)(num(p) | 2);
+}
+
+/* Allocate a zeroed packed array */
+any consArr(int type, long cnt) {
+   int i;
+   size_t n = cnt << type/2;
+
+   if ((ArrBytes += n) > ARR_GC)
+      SweepH = NULL,  gc();
+   for (i = 0;  i < ArrCnt  &&  Arrs[i].hdr;  ++i);
+   if (i == ArrCnt) {
+      Arrs = alloc(Arrs, (ArrCnt + 8) * sizeof(arrInfo));
+      memset(Arrs + ArrCnt, 0, 8 * sizeof(arrInfo));
+      ArrCnt += 8;
+   }
+   memset(Arrs[i].buf = alloc(NULL, n ?: 1), 0, n);
+   Arrs[i].cnt = cnt,  Arrs[i].type = type;
+   return Arrs[i].hdr = consHeap(Arr, box(i));
+}
+
+/* Remember an object outside of the current scope referring to an arena cell */
+void arenaRef(any x, any y) {
+   if ((cell*)y >= Arena  &&  (cell*)y < Env.arena  &&
+         ((cell*)x < Arena  ||  (cell*)x >= Arena + ARENA  ||  x < y)  &&
+         (!isCell(ArenaRefs)  ||  car(ArenaRefs) != x) )
+      ArenaRefs = consHeap(x, ArenaRefs);
+}
+
+/* Move a dying arena cell to the heap, leaving a forward pointer */
+static any arenaFwd(any x) {
+   word i;
+   any y;
+
+   i = x - Arena;
+   if (ArenaFwd[i/BITS] & (word)1 << i%BITS)
+      return car(x);
+   y = consHeap(car(x), cdr(x));
+   ArenaFwd[i/BITS] |= (word)1 << i%BITS;
+   car(x) = y,  cdr(x) = Pending,  Pending = x;
+   return y;
+}
+
+/* Forward a slot, return YES if it still refers to an enclosing scope */
+static bool arenaSlot(any *x, cell *p) {
+   if (!isCell(*x)  ||  *x < Arena  ||  *x >= Arena + ARENA)
+      return NO;
+   if (*x < p)
+      return YES;
+   *x = arenaFwd(*x);
+   return NO;
+}
+
+/* Forward the value and properties of a symbol */
+static bool arenaSym(any s, cell *p) {
+   any y;
+   bool flg = arenaSlot(&val(s), p);
+
+   for (y = tail(s);  isCell(y);  y = car(y))
+      if (isCell(cdr(y))) {
+         flg |= arenaSlot(&cdr(y), p);
+         flg |= arenaSlot(&cadr(y), p);
+      }
+   return flg;
+}
+
+/* Close the arena scope starting at 'p', copying its live cells to the heap */
+static void arenaDrop(cell *p, catchFrame *f) {
+   int i;
+   word j;
+   any x, y, *r;
+   bindFrame *bnd;
+
+   Pending = Nil;
+   for (x = Env.stack;  x;  x = cdr(x))
+      arenaSlot(&car(x), p);
+   for (bnd = Env.bind;  bnd;  bnd = bnd->link)
+      for (i = bnd->cnt;  --i >= 0;) {
+         arenaSlot(&val(bnd->bnd[i].sym), p);
+         arenaSlot(&bnd->bnd[i].val, p);
+      }
+   arenaSlot(&val(At), p),  arenaSlot(&val(At2), p);
+   arenaSlot(&val(At3), p),  arenaSlot(&val(Up), p);
+   for (r = &ArenaRefs;  isCell(x = *r);)
+      if (!isSym(y = car(x))  &&  y >= p  &&  y < Arena + ARENA)
+         *r = cdr(x);
+      else if (isSym(y)? arenaSym(y, p) : arenaSlot(&car(y), p) | arenaSlot(&cdr(y), p))
+         r = &cdr(x);
+      else
+         *r = cdr(x);
+   while (!isNil(Pending)) {  // Breadth-first, no recursion
+      y = car(x = Pending),  Pending = cdr(x);
+      if (arenaSlot(&car(y), p) | arenaSlot(&cdr(y), p))
+         ArenaRefs = consHeap(y, ArenaRefs);
+   }
+   if (Env.make  &&  Env.make != Env.yoke  &&
+         (x = (any)(Env.make - 1)) >= p  &&  x < Arena + ARENA) {
+      j = x - Arena;
+      if (ArenaFwd[j/BITS] & (word)1 << j%BITS)  // Tail of a 'make' list moved
+         Env.make = &cdr(car(x));
+   }
+   memset(ArenaFwd, 0, sizeof(ArenaFwd));
+   flushMeth(),  flushProp();
+   while (f  &&  f->fin != ArenaFin)
+      f = f->link;
+   Env.arena = f? p : NULL;
+}
+
+/* Leave a 'with-arena' scope on 'throw' or error */
+static any arenaEnd(any ex __attribute__((unused))) {
+   cell c1;
+
+   Push(c1, Thrown ?: Nil);
+   arenaDrop(Env.arena, CatchPtr->link);
+   Thrown = Pop(c1);
+   return Nil;
+}
+
+// (with-arena . prg) -> any
+any doWithArena(any ex) {
+   catchFrame f;
+   cell c1;
+
+   if (!Arena) {
+      Arena = (cell*)alloc(NULL, ARENA*sizeof(cell));
+      ArenaRefs = Nil;
+      ArenaFin = consSym(boxSubr(arenaEnd), 0);
+      ArenaFin = consHeap(ArenaFin, Nil);
+   }
+   f.tag = NULL,  f.fin = ArenaFin;
+   f.link = CatchPtr,  CatchPtr = &f;
+   Env.arena = Env.arena ?: Arena;
+   f.env = Env;
+   Push(c1, prog(cdr(ex)));
+   CatchPtr = f.link;
+   arenaDrop(f.env.arena, CatchPtr);
+   return Pop(c1);
+}
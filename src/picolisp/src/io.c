@@ -364,8 +364,10 @@ static any read0(bool top) {
             p = (any)&tail(x);
             while (isCell(car(p)))
                car(p) = caar(p);
+            flushProp();
             while (isCell(y = cdr(y)))
-               car(p) = cons(car(p),car(y)),  p = car(p);
+               car(p) = consHeap(car(p),car(y)),  p = car(p);
+            ArenaRef(x, cdr(data(c1)));
          }
       }
       drop(c1);
@@ -398,7 +400,7 @@ static any read0(bool top) {
    putByte1(Chr, &i, &w, &p);
    for (;;) {
       Env.get();
-      if (strchr(Delim, Chr))
+      if (Chr < 0 || strchr(Delim, Chr))
          break;
       if (Chr == '\\')
          Env.get();
@@ -411,9 +413,8 @@ static any read0(bool top) {
       return x;
    if (x = isIntern(tail(y), Intern))
       return x;
-   intern(y, Intern);
    val(y) = Nil;
-   return y;
+   return intern(y, Intern);
 }
 
 any read1(int end) {
@@ -478,9 +479,8 @@ any token(any x, int c) {
          y = popSym(i, w, p, &c1);
          if (x = isIntern(tail(y), Intern))
             return x;
-         intern(y, Intern);
          val(y) = Nil;
-         return y;
+         return intern(y, Intern);
       }
    }
    y = mkTxt(c = Chr);
@@ -527,7 +527,7 @@ any doChar(any ex) {
       return x;
    }
    if (isNum(x = EVAL(car(x)))) {
-      int c = (int)unBox(x);
+      int c = (int)xNum(ex,x);
 
       if (c == 0)
          return Nil;
@@ -866,12 +866,47 @@ void newline(void) {Env.put('\n');}
 void space(void) {Env.put(' ');}
 
 void outString(char *s) {
-   while (*s)
-      Env.put(*s++);
+   if (Env.put == putStdout)
+      fputs(s, OutFile);
+   else
+      while (*s)
+         Env.put(*s++);
+}
+
+static char Digits[] =
+   "0001020304050607080910111213141516171819"
+   "2021222324252627282930313233343536373839"
+   "4041424344454647484950515253545556575859"
+   "6061626364656667686970717273747576777879"
+   "8081828384858687888990919293949596979899";
+
+/* Digits of 'w' ending at 'p', zero-padded to 'n', return the start */
+char *decDigits(char *p, word w, int n) {
+   word q;
+
+   for (;  w >= 100;  w = q, n -= 2) {
+      q = w / 100;  // Compiles to a multiply by the reciprocal
+      memcpy(p -= 2, Digits + 2 * (w - q * 100), 2);
+   }
+   if (w >= 10)
+      memcpy(p -= 2, Digits + 2 * w, 2),  n -= 2;
+   else
+      *--p = '0' + w,  --n;
+   while (--n >= 0)
+      *--p = '0';
+   return p;
 }
 
 int bufNum(char buf[BITS/2], long n) {
-   return sprintf(buf, "%ld", n);
+   char tmp[BITS/2], *p;
+   int len;
+
+   p = decDigits(tmp + BITS/2, n < 0? -(word)n : (word)n, 0);
+   if (n < 0)
+      *--p = '-';
+   memcpy(buf, p, len = tmp + BITS/2 - p);
+   buf[len] = '\0';
+   return len;
 }
 
 void outNum(long n) {
@@ -881,6 +916,13 @@ void outNum(long n) {
    outString(buf);
 }
 
+void prNum(any x) {
+   char buf[numSize(x)];
+
+   bufBig(buf, x);
+   outString(buf);
+}
+
 void prIntern(any nm) {
    int i, c;
    word w;
@@ -913,7 +955,7 @@ void prTransient(any nm) {
 /* Print one expression */
 void print(any x) {
    if (isNum(x))
-      outNum(unBox(x));
+      prNum(x);
    else if (isSym(x)) {
       any nm = name(x);
 
@@ -926,6 +968,9 @@ void print(any x) {
    }
    else if (car(x) == Quote  &&  x != cdr(x))
       Env.put('\''),  print(cdr(x));
+   else if (car(x) == Exec)  // Compiled body prints as its source
+      for (x = cadr(x);  print(car(x)), isCell(x = cdr(x));)
+         space();
    else {
       any y;
 
@@ -963,7 +1008,7 @@ void print(any x) {
 void prin(any x) {
    if (!isNil(x)) {
       if (isNum(x))
-         outNum(unBox(x));
+         prNum(x);
       else if (isSym(x)) {
          int i, c;
          word w;
@@ -979,6 +1024,8 @@ void prin(any x) {
                Env.put(c &= 0x1F);
          }
       }
+      else if (car(x) == Exec)
+         prin(cadr(x));
       else {
          while (prin(car(x)), !isNil(x = cdr(x))) {
             if (!isCell(x)) {
@@ -1060,7 +1107,7 @@ static void save(any x) {
    any y, nm;
 
    if (isNum(x))
-      outNum(unBox(x));
+      prNum(x);
    else if (isSym(x)) {
       if (x == isIntern(nm = name(x), Intern))
          prIntern(nm);
@@ -3,6 +3,12 @@
  */
 
 #include "pico.h"
+#include "platform_conf.h"
+
+#ifndef STACK_SIZE_TOTAL
+#define STACK_SIZE_TOTAL (1024*1024)  // Hosted build
+#endif
+#define STACK_RESERVE (STACK_SIZE_TOTAL/4)  // For callers of picolisp_main and err()
 
 /* Globals */
 int Chr, Trace;
@@ -10,13 +16,15 @@ char **AV, *AV0, *Home;
 heap *Heaps;
 cell *Avail;
 stkEnv Env;
+gcStat GcStat;
 catchFrame *CatchPtr;
+ptr StkBase, StkLimit, StkLow;
 FILE *InFile, *OutFile;
 any TheKey, TheCls, Thrown;
 any Intern[2], Transient[2], Reloc;
 any ApplyArgs, ApplyBody;
-any Nil, Meth, Quote, T, At, At2, At3, This;
-any Dbg, Scl, Class, Up, Err, Msg, Bye;
+any Nil, Meth, Quote, Exec, Arr, T, At, At2, At3, This;
+any Dbg, Scl, Comp, Class, Up, Err, Msg, Bye;
 
 static bool Jam;
 static jmp_buf ErrRst;
@@ -58,6 +66,8 @@ void heapAlloc(void) {
 
    h = (heap*)((long)alloc(NULL, sizeof(heap) + sizeof(cell)) + (sizeof(cell)-1) & ~(sizeof(cell)-1));
    h->next = Heaps,  Heaps = h;
+   heapLink(h);
+   ++GcStat.add,  GcStat.base += CELLS;
    p = h->cells + CELLS-1;
    do
       Free(p);
@@ -76,33 +86,87 @@ any doHeap(any x) {
       while (h = h->next);
       return box(n);
    }
-   for (x = Avail;  x;  x = car(x))
-      ++n;
-   return box(n / CELLS);
+   return box((GcStat.base - GcStat.cells) / CELLS);
+}
+
+// (stack ['flg]) -> cnt
+any doStack(any x) {
+   long n = StkBase - StkLow;
+
+   x = cdr(x);
+   if (!isNil(EVAL(car(x))))
+      StkLow = StkBase;
+   return box(n);
+}
+
+/* Alist of the symbols bound from 'p' on, innermost binding first.
+ * Fails when it grows beyond ENV_SCAN symbols. */
+static bool envScan(bindFrame *p, cell *c) {
+   int i, n;
+   any x;
+
+   for (;  p;  p = p->link)
+      if (p->i == 0)
+         for (i = p->cnt;  --i >= 0;) {
+            for (x = data(*c), n = 0;  isCell(x);  x = cdr(x), ++n)
+               if (caar(x) == p->bnd[i].sym)
+                  break;
+            if (!isCell(x)) {
+               if (n == ENV_SCAN)
+                  return NO;
+               data(*c) = cons(cons(p->bnd[i].sym, val(p->bnd[i].sym)), data(*c));
+            }
+         }
+   return YES;
+}
+
+/* Clear the marks set by envMark() in the values of bound symbols */
+static void envUnmark(bindFrame *p) {
+   int i;
+
+   for (;  p;  p = p->link)
+      if (p->i == 0)
+         for (i = p->cnt;  --i >= 0;)
+            *(word*)&val(p->bnd[i].sym) &= ~1;
+}
+
+/* Same alist as envScan(), in linear time. Values are marked only
+ * while nothing is allocated. */
+static void envMark(bindFrame *p, cell *c) {
+   int i, n = 0;
+   any x, y;
+   bindFrame *q;
+
+   for (q = p;  q;  q = q->link)
+      if (q->i == 0)
+         for (i = q->cnt;  --i >= 0;)
+            if (!(num(val(q->bnd[i].sym)) & 1))
+               *(word*)&val(q->bnd[i].sym) |= 1,  ++n;
+   envUnmark(p);
+   for (data(*c) = Nil;  --n >= 0;)
+      data(*c) = cons(cons(Nil,Nil), data(*c));
+   for (x = data(*c), q = p;  q;  q = q->link)
+      if (q->i == 0)
+         for (i = q->cnt;  --i >= 0;)
+            if (!(num(val(q->bnd[i].sym)) & 1)) {
+               caar(x) = q->bnd[i].sym,  cdar(x) = val(q->bnd[i].sym);
+               *(word*)&val(q->bnd[i].sym) |= 1,  x = cdr(x);
+            }
+   envUnmark(p);
+   for (x = data(*c), data(*c) = Nil;  isCell(x);  data(*c) = y)
+      y = x,  x = cdr(x),  cdr(y) = data(*c);
 }
 
 // (env ['lst] | ['sym 'val] ..) -> lst
 any doEnv(any x) {
-   int i;
    bindFrame *p;
    cell c1, c2;
 
    Push(c1,Nil);
    if (!isCell(x = cdr(x))) {
-      for (p = Env.brk? Env.bind->link : Env.bind;  p;  p = p->link) {
-         if (p->i == 0) {
-            for (i = p->cnt;  --i >= 0;) {
-               for (x = data(c1); ; x = cdr(x)) {
-                  if (!isCell(x)) {
-                     data(c1) = cons(cons(p->bnd[i].sym, val(p->bnd[i].sym)), data(c1));
-                     break;
-                  }
-                  if (caar(x) == p->bnd[i].sym)
-                     break;
-               }
-            }
-         }
-      }
+      p = Env.brk? Env.bind->link : Env.bind;
+      if (!envScan(p, &c1))
+         envMark(p, &c1);
    }
    else {
       do {
@@ -128,16 +192,16 @@ any doEnv(any x) {
 }
 
 // (up [cnt] sym ['val]) -> any
-any doUp(any x) {
-   any y, *val;
+any doUp(any ex) {
+   any x, y, *val;
    int cnt, i;
    bindFrame *p;
 
-   x = cdr(x);
+   x = cdr(ex);
    if (!isNum(y = car(x)))
       cnt = 1;
    else
-      cnt = (int)unBox(y),  x = cdr(x),  y = car(x);
+      cnt = (int)xNum(ex,y),  x = cdr(x),  y = car(x);
    for (p = Env.brk? Env.bind->link : Env.bind, val = &val(y);  p;  p = p->link) {
       if (p->i <= 0) {
          for (i = 0;  i < p->cnt;  ++i)
@@ -189,7 +253,7 @@ bool equal(any x, any y) {
    if (x == y)
       return YES;
    if (isNum(x))
-      return NO;
+      return isBig(x) && isBig(y) && numCmp(x,y) == 0;
    if (isSym(x)) {
       if (!isSymb(y))
          return NO;
@@ -256,6 +320,8 @@ bool equal(any x, any y) {
 int compare(any x, any y) {
    any a, b;
 
+   if (isShort2(x,y))
+      return (num(x) > num(y)) - (num(x) < num(y));
    if (x == y)
       return 0;
    if (isNil(x))
@@ -265,7 +331,7 @@ int compare(any x, any y) {
    if (isNum(x)) {
       if (!isNum(y))
          return isNil(y)? +1 : -1;
-      return num(x) - num(y);
+      return numCmp(x,y);
    }
    if (isSym(x)) {
       int c, d, i, j;
@@ -303,14 +369,42 @@ int compare(any x, any y) {
 }
 
 /*** Error handling ***/
+/* Catch frame with a string contained in 'msg', set '*p' to that string */
+static catchFrame *errCatch(char *msg, any *p) {
+   catchFrame *q;
+   any y;
+
+   for (q = CatchPtr;  q;  q = q->link)
+      for (y = q->tag;  isCell(y);  y = cdr(y))
+         if (isSymb(car(y))) {
+            char s[bufSize(car(y))];
+
+            bufString(car(y), s);
+            if (strstr(msg, s))
+               return *p = car(y),  q;
+         }
+   return NULL;
+}
+
 void err(any ex, any x, char *fmt, ...) {
    va_list ap;
    char msg[240];
    outFrame f;
+   catchFrame *q;
 
    Chr = 0;
    Reloc = Nil;
    Env.brk = NO;
+   va_start(ap,fmt);
+   vsnprintf(msg, sizeof(msg), fmt, ap);
+   va_end(ap);
+   if (msg[0]  &&  (q = errCatch(msg, &Thrown))) {  // (catch '("msg" ..) ..)
+      if (ex)
+         val(Up) = ex;
+      val(Msg) = mkStr(msg);
+      unwind(q);
+      longjmp(q->rst, 1);
+   }
    f.fp = stderr;
    pushOutFiles(&f);
    while (*AV  &&  strcmp(*AV,"-") != 0)
@@ -319,20 +413,19 @@ void err(any ex, any x, char *fmt, ...) {
       outString("!? "), print(val(Up) = ex), newline();
    if (x)
       print(x), outString(" -- ");
-   va_start(ap,fmt);
-   vsnprintf(msg, sizeof(msg), fmt, ap);
-   va_end(ap);
    if (msg[0]) {
       outString(msg), newline();
       val(Msg) = mkStr(msg);
       if (!isNil(val(Err)) && !Jam)
          Jam = YES,  prog(val(Err)),  Jam = NO;
-      load(NULL, '?', Nil);
+      if (StkLimit > StkBase - STACK_SIZE_TOTAL)  // No break after stack overflow
+         load(NULL, '?', Nil);
    }
    unwind(NULL);
    Env.stack = NULL;
    Env.next = -1;
    Env.make = Env.yoke = NULL;
+   Env.arena = NULL;
    Env.parser = NULL;
    Trace = 0;
    longjmp(ErrRst, +1);
@@ -357,6 +450,20 @@ void numError(any ex, any x) {err(ex, x, "Number expected");}
 void symError(any ex, any x) {err(ex, x, "Symbol expected");}
 void pairError(any ex, any x) {err(ex, x, "Cons pair expected");}
 void atomError(any ex, any x) {err(ex, x, "Atom expected");}
+void stkError(any ex, any x) {err(ex, x, "Unbalanced stack");}
+
+/* New low-water mark of the C stack. It is kept at or above 'StkLimit',
+ * so that every frame beyond the limit comes here. */
+void stkLow(any ex, ptr p) {
+   if (p < StkLimit) {
+      StkLow = StkLimit;
+      if (StkLimit == StkBase - STACK_SIZE_TOTAL)
+         giveup("Stack overflow");
+      StkLimit = StkBase - STACK_SIZE_TOTAL;  // Let err() use the reserve
+      err(ex, NULL, "Stack overflow");
+   }
+   StkLow = p;
+}
 void lstError(any ex, any x) {err(ex, x, "List expected");}
 void varError(any ex, any x) {err(ex, x, "Variable expected");}
 void protError(any ex, any x) {err(ex, x, "Protected symbol");}
@@ -414,7 +521,20 @@ void unwind(catchFrame *catch) {
 }
 
 /*** Evaluation ***/
-any evExpr(any expr, any x) {
+/* Parameter list of at most four symbols, without rest arguments */
+bool isFixed(any y) {
+   int n = 4;
+
+   while (isCell(y)) {
+      if (--n < 0)
+         return NO;
+      y = cdr(y);
+   }
+   return isNil(y);
+}
+
+/* Evaluate a lambda with any parameter list */
+static any evVar(any expr, any x) {
    any y = car(expr);
    struct {  // bindFrame
       struct bindFrame *link;
@@ -472,8 +592,159 @@ any evExpr(any expr, any x) {
    return x;
 }
 
+/* Run 'prg' up to its last form */
+static any last(any x) {
+   if (!isCell(x))
+      return Nil;
+   while (isCell(cdr(x)))
+      EVAL(car(x)),  x = cdr(x);
+   return car(x);
+}
+
+/* Descend into flow functions down to the form in tail position */
+static any tailForm(any x) {
+   any y, a;
+
+   while (isCell(x)  &&  isSymb(y = car(x))  &&  isNum(y = val(y))) {
+      if (y == boxSubr(doIf)) {
+         x = cdr(x);
+         if (isNil(a = EVAL(car(x))))
+            x = last(cddr(x));
+         else
+            val(At) = a,  x = cadr(x);
+      }
+      else if (y == boxSubr(doIfn)) {
+         x = cdr(x);
+         if (!isNil(a = EVAL(car(x))))
+            val(At) = a,  x = last(cddr(x));
+         else
+            x = cadr(x);
+      }
+      else if (y == boxSubr(doWhen)) {
+         x = cdr(x);
+         if (isNil(a = EVAL(car(x))))
+            return Nil;
+         val(At) = a,  x = last(cdr(x));
+      }
+      else if (y == boxSubr(doUnless)) {
+         x = cdr(x);
+         if (!isNil(a = EVAL(car(x)))) {
+            val(At) = a;
+            return Nil;
+         }
+         x = last(cdr(x));
+      }
+      else if (y == boxSubr(doCond)) {
+         do
+            if (!isCell(x = cdr(x)))
+               return Nil;
+         while (isNil(a = EVAL(caar(x))));
+         val(At) = a,  x = last(cdar(x));
+      }
+      else if (y == boxSubr(doProg))
+         x = last(cdr(x));
+      else
+         break;
+   }
+   return x;
+}
+
+/* Number of parameters not bound in the frame yet */
+static int unbound(bindFrame *p, any y) {
+   int i, n;
+
+   for (n = 0;  isCell(y);  y = cdr(y)) {
+      for (i = p->cnt;  --i >= 0  &&  p->bnd[i].sym != car(y););
+      if (i < 0)
+         ++n;
+   }
+   return n;
+}
+
+/* Move a parameter of a tail call to the end of the frame, or add it
+ * there with its current value, so that 'env' sees the same order as
+ * for a nested call */
+static any tailBind(bindFrame *p, any s) {
+   int i;
+   any v;
+
+   for (i = p->cnt;  --i >= 0;)
+      if (p->bnd[i].sym == s) {
+         for (v = p->bnd[i].val;  i < p->cnt - 1;  ++i)
+            p->bnd[i] = p->bnd[i+1];
+         p->bnd[i].sym = s,  p->bnd[i].val = v;
+         return s;
+      }
+   p->bnd[p->cnt].sym = s,  p->bnd[p->cnt++].val = val(s);
+   return s;
+}
+
+/* Fixed-arity lambdas get a frame of constant size */
+any evExpr(any expr, any x) {
+   any y = car(expr);
+   int n;
+   struct {  // bindFrame
+      struct bindFrame *link;
+      int i, cnt;
+      struct {any sym; any val;} bnd[5];
+   } f;
+
+   if (!isFixed(y))
+      return evVar(expr, x);
+   f.link = Env.bind,  Env.bind = (bindFrame*)&f;
+   f.i = 1;
+   f.cnt = 1,  f.bnd[0].sym = At,  f.bnd[0].val = val(At);
+   while (isCell(y)) {
+      f.bnd[f.cnt].sym = car(y);
+      f.bnd[f.cnt].val = EVAL(car(x));
+      ++f.cnt, x = cdr(x), y = cdr(y);
+   }
+   n = f.cnt;
+   do {
+      x = val(f.bnd[--n].sym);
+      val(f.bnd[n].sym) = f.bnd[n].val;
+      f.bnd[n].val = x;
+   } while (n);
+   f.i = 0;
+   x = cdr(expr);
+   for (;;) {  // Calls in tail position reuse the frame
+      cell c[4];
+
+      x = tailForm(last(x));
+      if (!isCell(x)  ||  !isSymb(car(x))  ||  !isCell(y = val(car(x)))  ||
+            !isFixed(car(y))  ||  f.cnt + unbound(Env.bind, car(y)) > 5 ) {
+         x = EVAL(x);
+         break;
+      }
+      for (n = 0, expr = y, y = car(expr);  isCell(y);  ++n, y = cdr(y))
+         x = cdr(x),  Push(c[n], EVAL(car(x)));
+      tailBind(Env.bind, At);
+      for (n = 0, y = car(expr);  isCell(y);  ++n, y = cdr(y))
+         val(tailBind(Env.bind, car(y))) = data(c[n]);
+      if (n)
+         drop(c[0]);
+      x = cdr(expr);
+   }
+   while (--f.cnt >= 0)
+      val(f.bnd[f.cnt].sym) = f.bnd[f.cnt].val;
+   Env.bind = f.link;
+   return x;
+}
+
 void undefined(any x, any ex) {err(ex, x, "Undefined");}
 
+#ifdef PICOLISP_DEBUG
+/* Call a built-in and check that it dropped everything it pushed */
+any subrCheck(any f, any ex) {
+   cell *p = Env.stack;
+
+   f = callSubr(f,ex);
+   if (Env.stack != p)
+      stkError(ex, NULL);
+   return f;
+}
+#endif
+
 static any evList2(any foo, any ex) {
    cell c1;
 
@@ -503,6 +774,7 @@ static any evList2(any foo, any ex) {
 any evList(any ex) {
    any foo;
 
+   NeedStack(ex);
    if (isNum(foo = car(ex)))
       return ex;
    if (isCell(foo)) {
@@ -525,7 +797,22 @@ long evNum(any ex, any x) {return xNum(ex, EVAL(car(x)));}
 
 long xNum(any ex, any x) {
    NeedNum(ex,x);
-   return unBox(x);
+   if (isShort(x))
+      return unBox(x);
+   if (!isBig(cdr(bigCell(x)))  &&  (long)car(bigCell(x)) >= 0)
+      return cdr(bigCell(x)) == One? -(long)car(bigCell(x)) : (long)car(bigCell(x));
+   err(ex, x, "Number too big");
+}
+
+/* Low word of a number, modulo the word size */
+word xWord(any ex, any x) {
+   any y;
+
+   NeedNum(ex,x);
+   if (isShort(x))
+      return (word)unBox(x);
+   for (y = bigCell(x);  isBig(cdr(y));  y = bigCell(cdr(y)));
+   return cdr(y) == One? -(word)car(bigCell(x)) : (word)car(bigCell(x));
 }
 
 /* Evaluate any to sym */
@@ -549,11 +836,11 @@ any xSym(any x) {
 
 any boxSubr(fun f) {
 #ifdef ALCOR_BOARD_MIZAR32
-   if (num(f) & 3)
+   if (num(f) & 7)
       giveup("Unaligned Function");
-   return (any)(num(f) | 2);
+   return (any)(num(f) | 6);
 #else
-   return (any)((num(f) << 2) + 2);
+   return (any)((num(f) << 3) + 6);
 #endif
 }
 
@@ -704,6 +991,8 @@ int picolisp_main(int ac, char *av[]) {
 
    AV0 = *av++;
    AV = av;
+   StkLow = StkBase = (ptr)__builtin_frame_address(0);
+   StkLimit = StkBase - STACK_SIZE_TOTAL + STACK_RESERVE;
    heapAlloc();
    initSymbols();
    if (ac >= 2 && strcmp(av[ac-2], "+") == 0)
@@ -720,6 +1009,9 @@ int picolisp_main(int ac, char *av[]) {
    ApplyBody = cons(Nil,Nil);
    if (!setjmp(ErrRst))
       loadAll(NULL);
+   StkLimit = StkBase - STACK_SIZE_TOTAL + STACK_RESERVE;
+   if (StkLow < StkLimit)  // Reserve used by err()
+      StkLow = StkLimit;
    while (!feof(stdin))
       load(NULL, ':', Nil);
    return 0;
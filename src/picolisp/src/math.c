@@ -6,11 +6,258 @@
 
 static void divErr(any ex) {err(ex,NULL,"Div/0");}
 
+/* Bignums: a chain of cells, tagged with 010, holding raw digit words in
+ * the CARs, least significant first. The CDR of the last cell is Zero or
+ * One for the sign. Numbers fitting into SHORT_MAX are always short.
+ */
+
+/* Number of digit words */
+int numWords(any x) {
+   int n;
+
+   if (isShort(x))
+      return 1;
+   for (n = 0;  isBig(x);  x = cdr(bigCell(x)))
+      ++n;
+   return n;
+}
+
+/* Unpack the magnitude into digit words, return the sign */
+static bool bigUnpack(any x, word *d) {
+   long n;
+
+   if (isShort(x)) {
+      n = unBox(x);
+      *d = n < 0? -(word)n : (word)n;
+      return n < 0;
+   }
+   for (;  isBig(x);  x = cdr(bigCell(x)))
+      *d++ = (word)car(bigCell(x));
+   return x == One;
+}
+
+/* Pack digit words into a number */
+static any bigPack(word *d, int n, bool neg) {
+   any x;
+
+   while (n > 1  &&  !d[n-1])
+      --n;
+   if (n == 1  &&  d[0] <= SHORT_MAX)
+      return box(neg? -(long)d[0] : (long)d[0]);
+   for (x = neg? One : Zero;  --n >= 0;)
+      x = consNum(d[n], x);
+   return x;
+}
+
+any boxWord(word w) {return w <= SHORT_MAX? box(w) : consNum(w, Zero);}
+
+any boxLong(long n) {
+   word w = n < 0? -(word)n : (word)n;
+
+   return w <= SHORT_MAX? box(n) : consNum(w, n < 0? One : Zero);
+}
+
+/* Compare magnitudes */
+static int cmpMag(word *a, int na, word *b, int nb) {
+   while (na > nb)
+      if (a[--na])
+         return +1;
+   while (nb > na)
+      if (b[--nb])
+         return -1;
+   while (--na >= 0)
+      if (a[na] != b[na])
+         return a[na] > b[na]? +1 : -1;
+   return 0;
+}
+
+/* Add magnitudes into 'r' of max(na,nb)+1 words */
+static int addMag(word *a, int na, word *b, int nb, word *r) {
+   int i, n = na > nb? na : nb;
+   dword t;
+
+   for (t = 0, i = 0;  i < n;  ++i) {
+      t += (dword)(i < na? a[i] : 0) + (i < nb? b[i] : 0);
+      r[i] = (word)t,  t >>= BITS;
+   }
+   r[n] = (word)t;
+   return n + 1;
+}
+
+/* Subtract the magnitude 'b' from the not smaller 'a' */
+static int subMag(word *a, int na, word *b, int nb, word *r) {
+   int i;
+   word c, d, w;
+
+   for (c = 0, i = 0;  i < na;  ++i) {
+      d = i < nb? b[i] : 0;
+      w = a[i] - d - c;
+      c = a[i] < d  ||  a[i] - d < c;
+      r[i] = w;
+   }
+   return na;
+}
+
+/* Multiply by 'm' and add 'a' in place */
+static int mulAdd(word *d, int n, word m, word a) {
+   int i;
+   dword t;
+
+   for (i = 0;  i < n;  ++i) {
+      t = (dword)d[i] * m + a;
+      d[i] = (word)t,  a = (word)(t >> BITS);
+   }
+   if (a)
+      d[n++] = a;
+   return n;
+}
+
+/* Divide by 'm' in place, return the remainder */
+static word divSmall(word *d, int n, word m) {
+   word r;
+   dword t;
+
+   for (r = 0;  --n >= 0;) {
+      t = (dword)r << BITS | d[n];
+      d[n] = (word)(t / m),  r = (word)(t % m);
+   }
+   return r;
+}
+
+int bigCmp(any x, any y) {
+   int c, na = numWords(x), nb = numWords(y);
+   word a[na], b[nb];
+   bool neg;
+
+   if ((neg = bigUnpack(x, a)) != bigUnpack(y, b))
+      return neg? -1 : +1;
+   c = cmpMag(a, na, b, nb);
+   return neg? -c : c;
+}
+
+any bigAdd(any x, any y, bool sub) {
+   int na = numWords(x), nb = numWords(y);
+   word a[na], b[nb], r[(na > nb? na : nb) + 1];
+   bool nx, ny;
+
+   nx = bigUnpack(x, a);
+   ny = bigUnpack(y, b) ^ sub;
+   if (nx == ny)
+      return bigPack(r, addMag(a, na, b, nb, r), nx);
+   if (cmpMag(a, na, b, nb) >= 0)
+      return bigPack(r, subMag(a, na, b, nb, r), nx);
+   return bigPack(r, subMag(b, nb, a, na, r), ny);
+}
+
+any numNeg(any x) {return isShort(x)? box(-unBox(x)) : bigAdd(Zero, x, YES);}
+
+static any bigMul(any x, any y) {
+   int i, j, na = numWords(x), nb = numWords(y);
+   word c, a[na], b[nb], r[na+nb];
+   dword t;
+   bool neg;
+
+   neg = bigUnpack(x, a) != bigUnpack(y, b);
+   memset(r, 0, sizeof(r));
+   for (i = 0;  i < na;  ++i) {
+      for (c = 0, j = 0;  j < nb;  ++j) {
+         t = (dword)a[i] * b[j] + r[i+j] + c;
+         r[i+j] = (word)t,  c = (word)(t >> BITS);
+      }
+      r[i+nb] = c;
+   }
+   return bigPack(r, na+nb, neg);
+}
+
+any numMul(any x, any y) {
+   long n;
+
+   if (isShort2(x,y)  &&  !mulOvfl(num(x) - 6, unBox(y), &n))
+      return numBox(n | 6);
+   return bigMul(x, y);
+}
+
+/* Shift-subtract division, leaving the quotient in 'a' */
+static any bigDiv(any x, any y, bool rem) {
+   int i, j, na = numWords(x), nb = numWords(y);
+   word a[na], b[nb], r[nb+1];
+   bool nx, ny;
+
+   nx = bigUnpack(x, a),  ny = bigUnpack(y, b);
+   if (cmpMag(a, na, b, nb) < 0)
+      return rem? x : Zero;
+   if (nb == 1) {
+      r[0] = divSmall(a, na, b[0]);
+      return rem? bigPack(r, 1, nx) : bigPack(a, na, nx != ny);
+   }
+   memset(r, 0, sizeof(r));
+   for (i = na * BITS;  --i >= 0;) {
+      for (j = nb;  j > 0;  --j)
+         r[j] = r[j] << 1 | r[j-1] >> (BITS-1);
+      r[0] = r[0] << 1 | (a[i/BITS] >> i%BITS & 1);
+      a[i/BITS] &= ~((word)1 << i%BITS);
+      if (cmpMag(r, nb+1, b, nb) >= 0) {
+         subMag(r, nb+1, b, nb, r);
+         a[i/BITS] |= (word)1 << i%BITS;
+      }
+   }
+   return rem? bigPack(r, nb+1, nx) : bigPack(a, na, nx != ny);
+}
+
+/* Truncating division, or the remainder if 'rem' */
+any numDiv(any x, any y, bool rem) {
+   if (isShort2(x,y))
+      return box(rem? unBox(x) % unBox(y) : unBox(x) / unBox(y));
+   return bigDiv(x, y, rem);
+}
+
+#if __SIZEOF_LONG__ == 8
+#define DEC_BASE 10000000000000000000UL
+#define DEC_DIGITS 19
+#else
+#define DEC_BASE 1000000000UL
+#define DEC_DIGITS 9
+#endif
+
+/* Decimal representation of any number, return the length */
+int bufBig(char *buf, any x) {
+   int k, n = numWords(x);
+   word d[n], dec[2*n];
+   char *p, *q, top[DEC_DIGITS];
+
+   if (isShort(x))
+      return bufNum(buf, unBox(x));
+   p = buf;
+   if (bigUnpack(x, d))
+      *p++ = '-';
+   k = 0;
+   do {
+      dec[k++] = divSmall(d, n, DEC_BASE);
+      while (n > 1  &&  !d[n-1])
+         --n;
+   } while (n > 1  ||  d[0]);
+   q = decDigits(top + DEC_DIGITS, dec[--k], 0);
+   memcpy(p, q, n = top + DEC_DIGITS - q);
+   p += n;
+   while (--k >= 0)
+      decDigits(p += DEC_DIGITS, dec[k], DEC_DIGITS);
+   *p = '\0';
+   return p - buf;
+}
+
 /* Number of bytes */
 int numBytes(any x) {
    int n = 4;
-   word w = (word)x >> 2;
+   word w;
 
+   if (isBig(x)) {
+      for (n = 0;  isBig(cdr(bigCell(x)));  x = cdr(bigCell(x)))
+         n += PICOLISP_WORD;
+      for (w = (word)car(bigCell(x));  w;  w >>= 8)
+         ++n;
+      return n;
+   }
+   w = (word)x >> 3;
    if ((w & 0xFF000000) == 0) {
       --n;
       if ((w & 0xFF0000) == 0) {
@@ -22,28 +269,57 @@ int numBytes(any x) {
    return n;
 }
 
+/* Digit words needed for the number in a name */
+static int nameWords(any s, int scl) {
+   int n;
+
+   for (n = BITS/6;  !isTxt(s) && !isNum(s);  s = val(s))
+      n += BITS/6;
+   return (n + (scl > 0? scl : 0)) * 4 / BITS + 2;
+}
+
+/* Name bytes, decoded a word at a time */
+typedef struct nameBytes {
+   int i, k, n;
+   word w;
+   any s;
+   byte b[BITS/6 + 2];
+} nameBytes;
+
+static inline unsigned nextByte(nameBytes *r) {
+   if (r->k == r->n) {
+      if (!(r->n = getBytes(r->b, &r->i, &r->w, &r->s)))
+         return 0;
+      r->k = 0;
+   }
+   return r->b[r->k++];
+}
+
 /* Make number from symbol */
 any symToNum(any s, int scl, int sep, int ign) {
    unsigned c;
-   int i;
-   word w;
+   int n;
+   word v, m, d[nameWords(s, scl)];
    bool sign, frac;
-   long n;
+   nameBytes r;
 
-   if (!(c = getByte1(&i, &w, &s)))
+   r.k = r.n = 0;
+   if (!(c = getByte1(&r.i, &r.w, &s)))
       return NULL;
+   r.s = s;
    while (c <= ' ')  /* Skip white space */
-      if (!(c = getByte(&i, &w, &s)))
+      if (!(c = nextByte(&r)))
          return NULL;
    sign = NO;
    if (c == '+'  ||  c == '-' && (sign = YES))
-      if (!(c = getByte(&i, &w, &s)))
+      if (!(c = nextByte(&r)))
          return NULL;
    if ((c -= '0') > 9)
       return NULL;
    frac = NO;
-   n = c;
-   while ((c = getByte(&i, &w, &s))  &&  (!frac || scl)) {
+   n = 1,  d[0] = 0;
+   v = c,  m = 10;
+   while ((c = nextByte(&r))  &&  (!frac || scl)) {
       if ((int)c == sep) {
          if (frac)
             return NULL;
@@ -52,7 +328,9 @@ any symToNum(any s, int scl, int sep, int ign) {
       else if ((int)c != ign) {
          if ((c -= '0') > 9)
             return NULL;
-         n = n * 10 + c;
+         if (m > ~(word)0 / 10)
+            n = mulAdd(d, n, m, v),  v = 0,  m = 1;
+         v = v * 10 + c,  m *= 10;
          if (frac)
             --scl;
       }
@@ -61,47 +339,45 @@ any symToNum(any s, int scl, int sep, int ign) {
       if ((c -= '0') > 9)
          return NULL;
       if (c >= 5)
-         n += 1;
-      while (c = getByte(&i, &w, &s)) {
+         v += 1;
+      while (c = nextByte(&r)) {
          if ((c -= '0') > 9)
             return NULL;
       }
    }
    if (frac)
-      while (--scl >= 0)
-         n *= 10;
-   return box(sign? -n : n);
+      while (--scl >= 0) {
+         if (m > ~(word)0 / 10)
+            n = mulAdd(d, n, m, v),  v = 0,  m = 1;
+         v *= 10,  m *= 10;
+      }
+   if (n == 1  &&  !d[0]  &&  v <= SHORT_MAX)
+      return box(sign? -(long)v : (long)v);
+   return bigPack(d, mulAdd(d, n, m, v), sign);
 }
 
 /* Make symbol from number */
 any numToSym(any x, int scl, int sep, int ign) {
-   int i;
+   int i, n;
    word w;
    cell c1;
-   long n;
-   byte *p, buf[BITS/2];
+   char *p, buf[numSize(x)];
 
-   n = unBox(x);
+   n = bufBig(p = buf, x);
    putByte0(&i, &w, &x);
-   if (n < 0) {
-      n = -n;
+   if (*p == '-') {
       putByte('-', &i, &w, &x, &c1);
+      ++p,  --n;
    }
-   for (p = buf;;) {
-      *p = n % 10;
-      if ((n /= 10) == 0)
-         break;
-      ++p;
-   }
-   if ((scl = p - buf - scl) < 0) {
+   if ((scl = n - 1 - scl) < 0) {
       putByte('0', &i, &w, &x, &c1);
       putByte(sep, &i, &w, &x, &c1);
       while (scl < -1)
          putByte('0', &i, &w, &x, &c1),  ++scl;
    }
    for (;;) {
-      putByte(*p + '0', &i, &w, &x, &c1);
-      if (--p < buf)
+      putByte(*p++, &i, &w, &x, &c1);
+      if (--n == 0)
          return popSym(i, w, x, &c1);
       if (scl == 0)
          putByte(sep, &i, &w, &x, &c1);
@@ -140,73 +416,120 @@ any doFormat(any ex) {
    return Pop(c1);
 }
 
+/* Continue a sum or difference after leaving the short range */
+static any addRest(any ex, any x, any y, bool sub) {
+   cell c1;
+
+   Push(c1, y);
+   while (isCell(x = cdr(x))) {
+      if (isNil(y = EVAL(car(x)))) {
+         drop(c1);
+         return Nil;
+      }
+      NeedNum(ex,y);
+      data(c1) = bigAdd(data(c1), y, sub);
+   }
+   return Pop(c1);
+}
+
 // (+ 'num ..) -> num
 any doAdd(any ex) {
    any x, y;
-   long n;
+   long n, m;
 
    x = cdr(ex);
-   if (isNil(y = EVAL(car(x))))
-      return Nil;
-   NeedNum(ex,y);
-   n = unBox(y);
-   while (isCell(x = cdr(x))) {
-      if (isNil(y = EVAL(car(x))))
+   if (!isShort(y = EVAL(car(x)))) {
+      if (isNil(y))
          return Nil;
       NeedNum(ex,y);
-      n += unBox(y);
+      return addRest(ex, x, y, NO);
    }
-   return box(n);
+   n = num(y);
+   while (isCell(x = cdr(x))) {
+      if (!isShort(y = EVAL(car(x)))  ||  addOvfl(n, num(y) - 6, &m)) {
+         if (isNil(y))
+            return Nil;
+         NeedNum(ex,y);
+         return addRest(ex, x, bigAdd((any)n, y, NO), NO);
+      }
+      n = m;
+   }
+   return numBox(n);
 }
 
 // (- 'num ..) -> num
 any doSub(any ex) {
    any x, y;
-   long n;
+   long n, m;
 
    x = cdr(ex);
-   if (isNil(y = EVAL(car(x))))
-      return Nil;
-   NeedNum(ex,y);
-   n = unBox(y);
-   if (!isCell(x = cdr(x)))
-      return box(-n);
-   do {
-      if (isNil(y = EVAL(car(x))))
+   if (!isShort(y = EVAL(car(x)))) {
+      if (isNil(y))
          return Nil;
       NeedNum(ex,y);
-      n -= unBox(y);
-   } while (isCell(x = cdr(x)));
-   return box(n);
+      return isCell(cdr(x))? addRest(ex, x, y, YES) : numNeg(y);
+   }
+   if (!isCell(cdr(x)))
+      return numNeg(y);
+   n = num(y);
+   while (isCell(x = cdr(x))) {
+      if (!isShort(y = EVAL(car(x)))  ||  subOvfl(n, num(y) - 6, &m)) {
+         if (isNil(y))
+            return Nil;
+         NeedNum(ex,y);
+         return addRest(ex, x, bigAdd((any)n, y, YES), YES);
+      }
+      n = m;
+   }
+   return numBox(n);
+}
+
+// Bignum update of a variable
+static void bigVar(any var, any y, bool sub) {
+   cell c1;
+
+   Push(c1, var);
+   val(var) = bigAdd(val(var), y, sub);
+   drop(c1);
 }
 
 // (inc 'num) -> num
 // (inc 'var ['num]) -> num
 any doInc(any ex) {
    any x, y;
+   long n;
    cell c1;
 
    x = cdr(ex);
    if (isNil(data(c1) = EVAL(car(x))))
       return Nil;
    if (isNum(data(c1)))
-      return (any)(num(data(c1)) + 4);
+      return numInc(data(c1));
    CheckVar(ex,data(c1));
    if (!isCell(x = cdr(x))) {
-      if (isNil(val(data(c1))))
-         return Nil;
-      NeedNum(ex,val(data(c1)));
-      val(data(c1)) = (any)(num(val(data(c1))) + 4);
+      if (isShort(y = val(data(c1)))  &&  num(y) < num(box(SHORT_MAX)))
+         val(data(c1)) = (any)(num(y) + 8);
+      else {
+         if (isNil(y))
+            return Nil;
+         NeedNum(ex,y);
+         bigVar(data(c1), One, NO);
+      }
    }
    else {
       Save(c1);
       y = EVAL(car(x));
       drop(c1);
-      if (isNil(val(data(c1))) || isNil(y))
-         return Nil;
-      NeedNum(ex,val(data(c1)));
-      NeedNum(ex,y);
-      val(data(c1)) = box(unBox(val(data(c1))) + unBox(y));
+      if (isShort2(val(data(c1)), y)  &&
+            !addOvfl(num(val(data(c1))), num(y) - 6, &n)  &&  n != BOX_MIN)
+         val(data(c1)) = (any)n;
+      else {
+         if (isNil(val(data(c1))) || isNil(y))
+            return Nil;
+         NeedNum(ex,val(data(c1)));
+         NeedNum(ex,y);
+         bigVar(data(c1), y, NO);
+      }
    }
    return val(data(c1));
 }
@@ -215,157 +538,250 @@ any doInc(any ex) {
 // (dec 'var ['num]) -> num
 any doDec(any ex) {
    any x, y;
+   long n;
    cell c1;
 
    x = cdr(ex);
    if (isNil(data(c1) = EVAL(car(x))))
       return Nil;
    if (isNum(data(c1)))
-      return (any)(num(data(c1)) - 4);
+      return numDec(data(c1));
    CheckVar(ex,data(c1));
    if (!isCell(x = cdr(x))) {
-      if (isNil(val(data(c1))))
-         return Nil;
-      NeedNum(ex,val(data(c1)));
-      val(data(c1)) = (any)(num(val(data(c1))) - 4);
+      if (isShort(y = val(data(c1)))  &&  num(y) > num(MIN_SHORT))
+         val(data(c1)) = (any)(num(y) - 8);
+      else {
+         if (isNil(y))
+            return Nil;
+         NeedNum(ex,y);
+         bigVar(data(c1), One, YES);
+      }
    }
    else {
       Save(c1);
       y = EVAL(car(x));
       drop(c1);
-      if (isNil(val(data(c1))) || isNil(y))
+      if (isShort2(val(data(c1)), y)  &&
+            !subOvfl(num(val(data(c1))), num(y) - 6, &n)  &&  n != BOX_MIN)
+         val(data(c1)) = (any)n;
+      else {
+         if (isNil(val(data(c1))) || isNil(y))
+            return Nil;
+         NeedNum(ex,val(data(c1)));
+         NeedNum(ex,y);
+         bigVar(data(c1), y, YES);
+      }
+   }
+   return val(data(c1));
+}
+
+any boxDlong(dlong n) {
+   word d[2];
+   dword t = n < 0? -(dword)n : (dword)n;
+
+   d[0] = (word)t,  d[1] = (word)(t >> BITS);
+   return bigPack(d, 2, n < 0);
+}
+
+/* Continue a product after leaving the short range */
+static any mulRest(any ex, any x, any y) {
+   cell c1;
+
+   Push(c1, y);
+   while (isCell(x = cdr(x))) {
+      if (isNil(y = EVAL(car(x)))) {
+         drop(c1);
          return Nil;
-      NeedNum(ex,val(data(c1)));
+      }
       NeedNum(ex,y);
-      val(data(c1)) = box(unBox(val(data(c1))) - unBox(y));
+      data(c1) = numMul(data(c1), y);
    }
-   return val(data(c1));
+   return Pop(c1);
 }
 
 // (* 'num ..) -> num
 any doMul(any ex) {
    any x, y;
-   long n;
+   long n, m;
 
    x = cdr(ex);
-   if (isNil(y = EVAL(car(x))))
-      return Nil;
-   NeedNum(ex,y);
-   n = unBox(y);
-   while (isCell(x = cdr(x))) {
-      if (isNil(y = EVAL(car(x))))
+   if (!isShort(y = EVAL(car(x)))) {
+      if (isNil(y))
          return Nil;
       NeedNum(ex,y);
-      n *= unBox(y);
+      return mulRest(ex, x, y);
    }
-   return box(n);
+   n = num(y) - 6;
+   while (isCell(x = cdr(x))) {
+      if (!isShort(y = EVAL(car(x)))  ||  mulOvfl(n, unBox(y), &m)) {
+         if (isNil(y))
+            return Nil;
+         NeedNum(ex,y);
+         return mulRest(ex, x, bigMul((any)(n | 6), y));
+      }
+      n = m;
+   }
+   return numBox(n | 6);
 }
 
 // (*/ 'num1 ['num2 ..] 'num3) -> num
 any doMulDiv(any ex) {
    any x, y;
-   long long n;
+   dlong n;
+   bool small;
+   cell c1, c2;
 
    x = cdr(ex);
    if (isNil(y = EVAL(car(x))))
       return Nil;
    NeedNum(ex,y);
-   n = unBox(y);
+   Push(c1, y);
+   small = isShort(y),  n = small? unBox(y) : 0;
    for (;;) {
       x = cdr(x);
-      if (isNil(y = EVAL(car(x))))
+      if (isNil(y = EVAL(car(x)))) {
+         drop(c1);
          return Nil;
+      }
       NeedNum(ex,y);
       if (!isCell(cdr(x)))
          break;
-      n *= unBox(y);
+      if (small  &&  isShort(y)  &&  n == (long)n)
+         n *= unBox(y);
+      else {
+         if (small)
+            data(c1) = boxDlong(n),  small = NO;
+         data(c1) = numMul(data(c1), y);
+      }
    }
    if (y == Zero)
       divErr(ex);
-   return box((long)((n + unBox(y)/2) / unBox(y)));
+   if (small  &&  isShort(y)) {
+      drop(c1);
+      n = (n + unBox(y)/2) / unBox(y);
+      return n <= SHORT_MAX  &&  n >= -SHORT_MAX? box((long)n) : boxDlong(n);
+   }
+   if (small)
+      data(c1) = boxDlong(n);
+   Push(c2, y);
+   data(c1) = numAdd(data(c1), numDiv(y, box(2), NO));
+   data(c1) = numDiv(data(c1), y, NO);
+   return Pop(c1);
 }
 
 // (/ 'num ..) -> num
 any doDiv(any ex) {
    any x, y;
-   long n;
+   cell c1;
 
    x = cdr(ex);
    if (isNil(y = EVAL(car(x))))
       return Nil;
    NeedNum(ex,y);
-   n = unBox(y);
+   Push(c1, y);
    while (isCell(x = cdr(x))) {
-      if (isNil(y = EVAL(car(x))))
+      if (isNil(y = EVAL(car(x)))) {
+         drop(c1);
          return Nil;
+      }
       NeedNum(ex,y);
       if (y == Zero)
          divErr(ex);
-      n /= unBox(y);
+      data(c1) = numDiv(data(c1), y, NO);
    }
-   return box(n);
+   return Pop(c1);
 }
 
 // (% 'num ..) -> num
 any doRem(any ex) {
    any x, y;
-   long n;
+   cell c1;
 
    x = cdr(ex);
    if (isNil(y = EVAL(car(x))))
       return Nil;
    NeedNum(ex,y);
-   n = unBox(y);
+   Push(c1, y);
    while (isCell(x = cdr(x))) {
-      if (isNil(y = EVAL(car(x))))
+      if (isNil(y = EVAL(car(x)))) {
+         drop(c1);
          return Nil;
+      }
       NeedNum(ex,y);
       if (y == Zero)
          divErr(ex);
-      n %= unBox(y);
+      data(c1) = numDiv(data(c1), y, YES);
    }
-   return box(n);
+   return Pop(c1);
+}
+
+static any pow2(long n) {
+   int k = n / BITS;
+   word d[k+1];
+
+   memset(d, 0, sizeof(d));
+   d[k] = (word)1 << n%BITS;
+   return bigPack(d, k+1, NO);
 }
 
 // (>> 'num 'num) -> num
 any doShift(any ex) {
    any x, y;
    long n, m;
+   word w;
+   cell c1;
 
    x = cdr(ex),  n = evNum(ex,x);
    x = cdr(x);
    if (isNil(y = EVAL(car(x))))
       return Nil;
    NeedNum(ex,y);
-   if ((m = unBox(y)) >= 0)
-      m = n >= 0? m >> n : m << -n;
-   else
-      m = -(n >= 0? -m >> n : -m << -n);
-   return box(m);
+   if (n >= BITS * numWords(y))
+      return Zero;
+   if (isShort(y)) {
+      m = unBox(y),  w = m < 0? -(word)m : (word)m;
+      if (n >= 0)
+         return box(m < 0? -(long)(w >> n) : (long)(w >> n));
+      if (-n < BITS  &&  w <= (word)SHORT_MAX >> -n)
+         return box(m < 0? -(long)(w << -n) : (long)(w << -n));
+   }
+   Push(c1, y);
+   y = pow2(n >= 0? n : -n);
+   y = n >= 0? numDiv(data(c1), y, NO) : numMul(data(c1), y);
+   drop(c1);
+   return y;
+}
+
+/* Sign of a number */
+static bool isNeg(any x) {
+   if (isShort(x))
+      return num(x) < 0;
+   while (isBig(x = cdr(bigCell(x))));
+   return x == One;
 }
 
 // (lt0 'any) -> num | NIL
 any doLt0(any x) {
    x = cdr(x);
-   return isNum(x = EVAL(car(x))) && num(x)<0? x : Nil;
+   return isNum(x = EVAL(car(x))) && isNeg(x)? x : Nil;
 }
 
 // (le0 'any) -> num | NIL
 any doLe0(any x) {
    x = cdr(x);
-   return isNum(x = EVAL(car(x))) && num(x)<=num(Zero)? x : Nil;
+   return isNum(x = EVAL(car(x))) && (x == Zero || isNeg(x))? x : Nil;
 }
 
 // (ge0 'any) -> num | NIL
 any doGe0(any x) {
    x = cdr(x);
-   return isNum(x = EVAL(car(x))) && num(x)>=0? x : Nil;
+   return isNum(x = EVAL(car(x))) && !isNeg(x)? x : Nil;
 }
 
 // (gt0 'any) -> num | NIL
 any doGt0(any x) {
    x = cdr(x);
-   return isNum(x = EVAL(car(x))) && num(x)>num(Zero)? x : Nil;
+   return isNum(x = EVAL(car(x))) && x != Zero && !isNeg(x)? x : Nil;
 }
 
 // (abs 'num) -> num
@@ -376,74 +792,111 @@ any doAbs(any ex) {
    if (isNil(x = EVAL(car(x))))
       return Nil;
    NeedNum(ex,x);
-   return num(x)<0? box(-unBox(x)) : x;
+   return isNeg(x)? numNeg(x) : x;
+}
+
+/* Two's complement of a magnitude of 'n' words, in place if 'neg' */
+static void bigTwos(word *d, int n, bool neg) {
+   int i;
+   word c;
+
+   if (neg)
+      for (c = 1, i = 0;  i < n;  ++i)
+         d[i] = ~d[i] + c,  c = c && !d[i];
+}
+
+/* Bitwise operation on two's complement numbers of any size */
+static any bigLogic(any x, any y, int op) {
+   int na = numWords(x), nb = numWords(y), i, n = (na > nb? na : nb) + 1;
+   word a[n], b[n];
+   bool neg;
+
+   memset(a, 0, sizeof(a)),  memset(b, 0, sizeof(b));
+   bigTwos(a, n, bigUnpack(x, a));
+   bigTwos(b, n, bigUnpack(y, b));
+   for (i = 0;  i < n;  ++i)
+      a[i] = op == '&'? a[i] & b[i] : op == '|'? a[i] | b[i] : a[i] ^ b[i];
+   bigTwos(a, n, neg = a[n-1] >> (BITS-1));
+   return bigPack(a, n, neg);
+}
+
+static any numLogic(any x, any y, int op) {
+   if (isShort2(x,y))
+      return boxLong(op == '&'? unBox(x) & unBox(y) : op == '|'? unBox(x) | unBox(y) : unBox(x) ^ unBox(y));
+   return bigLogic(x, y, op);
 }
 
 // (bit? 'num ..) -> num | NIL
 any doBitQ(any ex) {
-   any x, y, z;
+   any x, y;
+   cell c1;
 
    x = cdr(ex),  y = EVAL(car(x));
    NeedNum(ex,y);
+   Push(c1, y);
    while (isCell(x = cdr(x))) {
-      if (isNil(z = EVAL(car(x))))
+      if (isNil(y = EVAL(car(x)))) {
+         drop(c1);
          return Nil;
-      NeedNum(ex,z);
-      if ((unBox(y) & unBox(z)) != unBox(y))
+      }
+      NeedNum(ex,y);
+      if (numCmp(numLogic(data(c1), y, '&'), data(c1))) {
+         drop(c1);
          return Nil;
+      }
    }
-   return y;
+   return Pop(c1);
 }
 
-// (& 'num ..) -> num
-any doBitAnd(any ex) {
-   any x, y, z;
+/* Fold the arguments with a bitwise operation */
+static any bitOp(any ex, int op) {
+   any x, y;
+   cell c1;
 
    x = cdr(ex);
    if (isNil(y = EVAL(car(x))))
       return Nil;
    NeedNum(ex,y);
+   Push(c1, y);
    while (isCell(x = cdr(x))) {
-      if (isNil(z = EVAL(car(x))))
+      if (isNil(y = EVAL(car(x)))) {
+         drop(c1);
          return Nil;
-      NeedNum(ex,z);
-      y = box(unBox(y) & unBox(z));
+      }
+      NeedNum(ex,y);
+      data(c1) = numLogic(data(c1), y, op);
    }
-   return y;
+   return Pop(c1);
 }
 
-// (| 'num ..) -> num
-any doBitOr(any ex) {
-   any x, y, z;
+// (& 'num ..) -> num
+any doBitAnd(any ex) {return bitOp(ex, '&');}
 
-   x = cdr(ex);
-   if (isNil(y = EVAL(car(x))))
-      return Nil;
-   NeedNum(ex,y);
-   while (isCell(x = cdr(x))) {
-      if (isNil(z = EVAL(car(x))))
-         return Nil;
-      NeedNum(ex,z);
-      y = box(unBox(y) | unBox(z));
-   }
-   return y;
-}
+// (| 'num ..) -> num
+any doBitOr(any ex) {return bitOp(ex, '|');}
 
 // (x| 'num ..) -> num
-any doBitXor(any ex) {
-   any x, y, z;
-
-   x = cdr(ex);
-   if (isNil(y = EVAL(car(x))))
-      return Nil;
-   NeedNum(ex,y);
-   while (isCell(x = cdr(x))) {
-      if (isNil(z = EVAL(car(x))))
-         return Nil;
-      NeedNum(ex,z);
-      y = box(unBox(y) ^ unBox(z));
+any doBitXor(any ex) {return bitOp(ex, '^');}
+
+/* Integer square root, two bits per step */
+static any bigSqrt(any x) {
+   int i, p, n = numWords(x);
+   word d[n], r[n], b[n];
+
+   bigUnpack(x, d);
+   memset(r, 0, sizeof(r));
+   for (p = n * BITS - 2;  p >= 0;  p -= 2) {
+      memcpy(b, r, sizeof(r));
+      b[p/BITS] |= (word)1 << p%BITS;  // Disjoint from the bits of 'r'
+      for (i = 0;  i < n-1;  ++i)
+         r[i] = r[i] >> 1 | r[i+1] << (BITS-1);
+      r[n-1] >>= 1;
+      if (cmpMag(b, n, d, n) <= 0) {
+         subMag(d, n, b, n, d);
+         r[p/BITS] |= (word)1 << p%BITS;
+      }
    }
-   return y;
+   return bigPack(r, n, NO);
 }
 
 // (sqrt 'num) -> num
@@ -455,10 +908,13 @@ any doSqrt(any ex) {
    if (isNil(x = EVAL(car(x))))
       return Nil;
    NeedNum(ex,x);
-	if ((n = unBox(x)) < 0)
+   if (isNeg(x))
       err(ex, x, "Bad argument");
+   if (isBig(x))
+      return bigSqrt(x);
+	n = unBox(x);
 	r = 0;
-	a = 1L << 28;
+	a = 1L << (BITS-4);
 	do {
 		b = r + a;
 		r >>= 1;
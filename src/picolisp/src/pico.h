@@ -30,8 +30,23 @@
 #endif
 
 #define CELLS (PC_MUL*1024/sizeof(cell))
+#define GC_STEP (CELLS/16)
+#define ARENA ((CELLS/8 + BITS-1) & ~(BITS-1))
+#define ARR_GC (CELLS*sizeof(cell))  // Array bytes allocated between collections
+#define METH_CACHE 6  // Log2 of method cache entries
+#define PROP_CACHE 6  // Log2 of property cache entries
+#define PROP_SCAN 4  // Properties searched before the cache
+#define ENV_SCAN 16  // Symbols 'env' checks for duplicates by searching
+#define HASH_MUL ((word)(PICOLISP_WORD == 8? 0x9E3779B97F4A7C15ULL : 0x9E3779B9UL))
 
 typedef unsigned long word;
+#if __SIZEOF_LONG__ == 8
+typedef __int128 dlong;  // Double words for bignum digits
+typedef unsigned __int128 dword;
+#else
+typedef long long dlong;
+typedef unsigned long long dword;
+#endif
 typedef unsigned char byte;
 typedef unsigned char *ptr;
 
@@ -47,6 +62,7 @@ typedef any (*fun)(any);
 
 typedef struct heap {
    cell cells[CELLS];
+   word marks[CELLS/BITS];
    struct heap *next;
 } heap;
 
@@ -76,7 +92,7 @@ typedef struct parseFrame {
 } parseFrame;
 
 typedef struct stkEnv {
-   cell *stack, *arg;
+   cell *stack, *arg, *arena;
    bindFrame *bind;
    int next;
    any key, cls, *make, *yoke;
@@ -88,6 +104,19 @@ typedef struct stkEnv {
    bool brk;
 } stkEnv;
 
+typedef struct gcStat {
+   word cells, base;  // Cells allocated, plus free cells
+   word gcs, freed;   // Collections, cells reclaimed
+   word add, del;     // Heap blocks added and freed
+} gcStat;
+
+typedef struct arrInfo {
+   any hdr;     // Header cell, NULL if the slot is free
+   void *buf;   // Packed elements
+   long cnt;    // Number of elements
+   int type;    // ARR_U8 .. ARR_S32
+} arrInfo;
+
 typedef struct catchFrame {
    struct catchFrame *link;
    any tag, fin;
@@ -95,16 +124,29 @@ typedef struct catchFrame {
    jmp_buf rst;
 } catchFrame;
 
+/* Packed array element types, log2 of the size in the upper bits */
+#define ARR_U8          0
+#define ARR_S8          1
+#define ARR_U16         2
+#define ARR_S16         3
+#define ARR_U32         4
+#define ARR_S32         5
+
 /*** Macros ***/
 #define Free(p)         ((p)->car=Avail, Avail=(p))
 
 /* Number access */
 #define num(x)          ((long)(x))
 #define txt(n)          ((any)(num(n)<<1|1))
-#define box(n)          ((any)(num(n)<<2|2))
-#define unBox(n)        (num(n)>>2)
-#define Zero            ((any)2)
-#define One             ((any)6)
+#define box(n)          ((any)(num(n)<<3|6))
+#define unBox(n)        (num(n)>>3)
+#define Zero            ((any)6)
+#define One             ((any)14)
+#define SHORT_MAX       ((long)(~(word)0 >> 4))
+#define MIN_SHORT       ((any)((word)-SHORT_MAX << 3 | 6))  // box(-SHORT_MAX)
+#define BOX_MIN         (num(MIN_SHORT) - 8)  // Tagged -SHORT_MAX-1
+#define bigCell(x)      ((any)(num(x)&~2))
+#define numSize(x)      (numWords(x)*BITS/3 + 3)
 
 /* Symbol access */
 #define symPtr(x)       ((any)&(x)->cdr)
@@ -135,13 +177,27 @@ typedef struct catchFrame {
 #define Push(c,x)       (data(c)=(x), Save(c))
 #define Pop(c)          (drop(c), data(c))
 
+/* Scoped roots: 'Unroot' must match the innermost 'Root' */
+#define Root(c,x)       cell c; Push(c,x)
+#ifdef PICOLISP_DEBUG
+# define Unroot(c)      ((Env.stack == &(c) || (stkError(NULL,NULL), 0)), drop(c))
+#else
+# define Unroot(c)      drop(c)
+#endif
+
 #define Bind(s,f)       ((f).i=0, (f).cnt=1, (f).bnd[0].sym=(s), (f).bnd[0].val=val(s), (f).link=Env.bind, Env.bind=&(f))
 #define Unbind(f)       (val((f).bnd[0].sym)=(f).bnd[0].val, Env.bind=(f).link)
 
+/* Arena write barrier, after storing 'y' into the object 'x' */
+#define ArenaRef(x,y)   (Env.arena && isCell(y)? arenaRef(x,y) : (void)0)
+
 /* Predicates */
 #define isNil(x)        ((x)==Nil)
 #define isTxt(x)        (num(x)&1)
 #define isNum(x)        (num(x)&2)
+#define isShort(x)      ((num(x)&6)==6)
+#define isBig(x)        ((num(x)&6)==2)
+#define isShort2(x,y)   ((num(x)&num(y)&6)==6)  // Both short
 #define isSym(x)        (num(x)&PICOLISP_WORD)
 #define isSymb(x)       ((num(x)&(PICOLISP_WORD+2))==PICOLISP_WORD)
 #define isCell(x)       (!(num(x)&(2*PICOLISP_WORD-1)))
@@ -150,9 +206,15 @@ typedef struct catchFrame {
 #define EVAL(x)         (isNum(x)? x : isSym(x)? val(x) : evList(x))
 
 #ifdef ALCOR_BOARD_MIZAR32
-# define evSubr(f,x)     (*(fun)(num(f) & ~2))(x)
+# define subrFun(f)      ((fun)(num(f) & ~6))
 #else
-# define evSubr(f,x)     (*(fun)(num(f) >> 2))(x)
+# define subrFun(f)      ((fun)((word)(f) >> 3))
+#endif
+#define callSubr(f,x)   (*subrFun(f))(x)
+#ifdef PICOLISP_DEBUG
+# define evSubr(f,x)     subrCheck(f,x)
+#else
+# define evSubr(f,x)     callSubr(f,x)
 #endif
 
 /* Error checking */
@@ -164,6 +226,8 @@ typedef struct catchFrame {
 #define NeedLst(ex,x)   if (!isCell(x) && !isNil(x)) lstError(ex,x)
 #define NeedVar(ex,x)   if (isNum(x)) varError(ex,x)
 #define CheckVar(ex,x)  if ((x)>=Nil && (x)<=T) protError(ex,x)
+#define NeedStack(ex)   if ((ptr)__builtin_frame_address(0) < StkLow) \
+                           stkLow(ex, (ptr)__builtin_frame_address(0))
 
 /* Globals */
 extern int Chr, Trace;
@@ -171,13 +235,17 @@ extern char **AV, *AV0, *Home;
 extern heap *Heaps;
 extern cell *Avail;
 extern stkEnv Env;
+extern gcStat GcStat;
+extern arrInfo *Arrs;
+extern int ArrCnt;
 extern catchFrame *CatchPtr;
+extern ptr StkBase, StkLimit, StkLow;
 extern FILE *InFile, *OutFile;
 extern any TheKey, TheCls, Thrown;
 extern any Intern[2], Transient[2], Reloc;
 extern any ApplyArgs, ApplyBody;
-extern any Nil, Meth, Quote, T, At, At2, At3, This;
-extern any Dbg, Scl, Class, Up, Err, Msg, Bye;
+extern any Nil, Meth, Quote, Exec, Arr, T, At, At2, At3, This;
+extern any Dbg, Scl, Comp, Class, Up, Err, Msg, Bye;
 
 // globals for picoLisp platform modules.
 
@@ -303,6 +371,7 @@ any plisp_spi_sson(any ex);
 any plisp_spi_ssoff(any ex);
 any plisp_spi_setup(any ex);
 any plisp_spi_write(any ex);
+any plisp_spi_readwrite(any ex);
 
 // gpio module.
 any plisp_pio_pin_setdir(any ex);
@@ -362,11 +431,22 @@ any plisp_ks0108b_prinl_big(any ex);
 int picolisp_main(int argc, char *argv[]);
 void *alloc(void*,size_t);
 any apply(any,any,bool,int,cell*);
+void arenaRef(any,any);
 void argError(any,any) __attribute__ ((noreturn));
+arrInfo *arrCheck(any,any);
+long arrGet(arrInfo*,long);
+any arrList(any,any);
+void arrSet(arrInfo*,long,long);
 void atomError(any,any) __attribute__ ((noreturn));
 void begString(void);
+any bigAdd(any,any,bool);
+int bigCmp(any,any);
+any boxDlong(dlong);
+any boxLong(long);
 any boxSubr(fun);
+any boxWord(word);
 void brkLoad(any);
+int bufBig(char*,any);
 int bufNum(char[BITS/2],long);
 int bufSize(any);
 void bufString(any,char*);
@@ -374,9 +454,14 @@ void bye(int) __attribute__ ((noreturn));
 void pairError(any,any) __attribute__ ((noreturn));
 any circ(any);
 int compare(any,any);
+void compFun(any);
 any cons(any,any);
+any consArr(int,long);
+any consHeap(any,any);
 any consName(word,any);
+any consNum(word,any);
 any consSym(any,word);
+char *decDigits(char*,word,int);
 void newline(void);
 any endString(void);
 bool equal(any,any);
@@ -387,15 +472,21 @@ long evNum(any,any);
 any evSym(any);
 void execError(char*) __attribute__ ((noreturn));
 int firstByte(any);
+void flushClass(any);
+void flushMeth(void);
+void flushProp(void);
 any get(any,any);
 int getByte(int*,word*,any*);
 int getByte1(int*,word*,any*);
+int getBytes(byte*,int*,word*,any*);
 void getStdin(void);
 void giveup(char*) __attribute__ ((noreturn));
 void heapAlloc(void);
+void heapLink(heap*);
 void initSymbols(void);
 any intern(any,any[2]);
 bool isBlank(any);
+bool isFixed(any);
 any isIntern(any,any[2]);
 void lstError(any,any) __attribute__ ((noreturn));
 any load(any,int,any);
@@ -408,8 +499,12 @@ any mkStr(const char*);
 any mkTxt(int);
 any name(any);
 int numBytes(any);
+any numDiv(any,any,bool);
 void numError(any,any) __attribute__ ((noreturn));
+any numMul(any,any);
+any numNeg(any);
 any numToSym(any,int,int,int);
+int numWords(any);
 void outName(any);
 void outNum(long);
 void outString(char*);
@@ -421,6 +516,7 @@ void popOutFiles(void);
 any popSym(int,word,any,cell*);
 void prin(any);
 void print(any);
+void prNum(any);
 void protError(any,any) __attribute__ ((noreturn));
 void pushInFiles(inFrame*);
 void pushOutFiles(outFrame*);
@@ -431,8 +527,14 @@ void putByte1(int,int*,word*,any*);
 void putStdout(int);
 void rdOpen(any,any,inFrame*);
 any read1(int);
+void romAll(void);
+any romSym(any);
+void rotate(any*,bool);
 int secondByte(any);
 void space(void);
+void stkError(any,any) __attribute__ ((noreturn));
+void stkLow(any,ptr);
+any subrCheck(any,any);
 int symBytes(any);
 void symError(any,any) __attribute__ ((noreturn));
 any symToNum(any,int,int,int);
@@ -442,6 +544,7 @@ void unwind (catchFrame*);
 void varError(any,any) __attribute__ ((noreturn));
 void wrOpen(any,any,outFrame*);
 long xNum(any,any);
+word xWord(any,any);
 any xSym(any);
 
 any doAbs(any);
@@ -454,12 +557,20 @@ any doApply(any);
 any doArg(any);
 any doArgs(any);
 any doArgv(any);
+any doArrGet(any);
+any doArrLen(any);
+any doArrList(any);
+any doArrNew(any);
+any doArrSet(any);
+any doArrSlice(any);
+any doArrWrite(any);
 any doArrow(any);
 any doAsoq(any);
 any doAs(any);
 any doAssoc(any);
 any doAt(any);
 any doAtom(any);
+any doBidx(any);
 any doBind(any);
 any doBitAnd(any);
 any doBitOr(any);
@@ -498,6 +609,7 @@ any doClip(any);
 any doCmd(any);
 any doCnt(any);
 any doCol(any);
+any doCompile(any);
 any doCon(any);
 any doConc(any);
 any doCond(any);
@@ -525,6 +637,7 @@ any doEq0(any);
 any doEqT(any);
 any doEqual(any);
 any doEval(any);
+any doExec(any);
 any doExtra(any);
 any doExtract(any);
 any doFifo(any);
@@ -544,6 +657,8 @@ any doFrom(any);
 any doFull(any);
 any doFunQ(any);
 any doGc(any);
+any doGcStats(any);
+any doGcStep(any);
 any doGe(any);
 any doGe0(any);
 any doGet(any);
@@ -553,6 +668,7 @@ any doGt(any);
 any doGt0(any);
 any doHead(any);
 any doHeap(any);
+any doHeapPolicy(any);
 any doHide(any);
 any doIdx(any);
 any doIf(any);
@@ -682,6 +798,7 @@ any doSpace(any);
 any doSplit(any);
 any doSpQ(any);
 any doSqrt(any);
+any doStack(any);
 any doState(any);
 any doStem(any);
 any doStr(any);
@@ -708,16 +825,87 @@ any doUp(any);
 any doUppQ(any);
 any doUppc(any);
 any doUse(any);
+any doVadd(any);
 any doVal(any);
+any doVcum(any);
+any doVdot(any);
+any doVfir(any);
+any doVmax(any);
+any doVmean(any);
+any doVmin(any);
+any doVscale(any);
 any doWhen(any);
 any doWhile(any);
 any doWith(any);
+any doWithArena(any);
 any doXchg(any);
 any doXor(any);
 any doYoke(any);
 any doZap(any);
 any doZero(any);
 
+/* Overflow checked word arithmetic */
+#if __GNUC__ >= 5
+#define addOvfl(a,b,r)  __builtin_add_overflow(a,b,r)
+#define subOvfl(a,b,r)  __builtin_sub_overflow(a,b,r)
+#define mulOvfl(a,b,r)  __builtin_mul_overflow(a,b,r)
+#else
+static inline bool addOvfl(long a, long b, long *r) {
+   *r = (long)((word)a + (word)b);
+   return ((a ^ *r) & (b ^ *r)) < 0;
+}
+
+static inline bool subOvfl(long a, long b, long *r) {
+   *r = (long)((word)a - (word)b);
+   return ((a ^ b) & (a ^ *r)) < 0;
+}
+
+static inline bool mulOvfl(long a, long b, long *r) {
+   dlong t = (dlong)a * b;
+
+   *r = (long)t;
+   return t != *r;
+}
+#endif
+
+/* Number arithmetic, inline for short numbers. Tagged shorts are added
+ * directly, so a word overflow is a short overflow. Only BOX_MIN gets
+ * through and needs a bignum.
+ */
+static inline any numBox(long n) {
+   return n != BOX_MIN? (any)n : bigAdd(MIN_SHORT, One, YES);
+}
+
+static inline int numCmp(any x, any y) {
+   if (isShort2(x,y))
+      return (num(x) > num(y)) - (num(x) < num(y));
+   return bigCmp(x,y);
+}
+
+static inline any numAdd(any x, any y) {
+   long n;
+
+   if (isShort2(x,y)  &&  !addOvfl(num(x), num(y) - 6, &n))
+      return numBox(n);
+   return bigAdd(x, y, NO);
+}
+
+static inline any numSub(any x, any y) {
+   long n;
+
+   if (isShort2(x,y)  &&  !subOvfl(num(x), num(y) - 6, &n))
+      return numBox(n);
+   return bigAdd(x, y, YES);
+}
+
+static inline any numInc(any x) {
+   return isShort(x) && num(x) < num(box(SHORT_MAX))? (any)(num(x) + 8) : bigAdd(x, One, NO);
+}
+
+static inline any numDec(any x) {
+   return isShort(x) && num(x) > num(MIN_SHORT)? (any)(num(x) - 8) : bigAdd(x, One, YES);
+}
+
 /* List element access */
 static inline any nCdr(int n, any x) {
    while (--n >= 0)
@@ -732,7 +920,7 @@ static inline any nth(int n, any x) {
 }
 
 static inline any getn(any x, any y) {
-   if (isNum(x)) {
+   if (isShort(x)) {
       long n = unBox(x);
 
       if (n < 0) {
@@ -141,6 +141,8 @@ any doCon(any ex) {
    x = cdr(ex),  Push(c1, EVAL(car(x)));
    NeedPair(ex,data(c1));
    x = cdr(x),  x = cdr(data(c1)) = EVAL(car(x));
+   ArenaRef(data(c1), x);
+   flushMeth();
    drop(c1);
    return x;
 }
@@ -171,7 +173,7 @@ any doConc(any x) {
       else {
          while (isCell(cdr(y)))
             y = cdr(y);
-         cdr(y) = z;
+         cdr(y) = z,  ArenaRef(y, z),  flushMeth();
       }
    }
    return Pop(c1);
@@ -304,10 +306,13 @@ any doChain(any x) {
       makeError(x);
    x = cdr(x);
    do
-      if (isCell(*Env.make = y = EVAL(car(x))))
+      if (isCell(*Env.make = y = EVAL(car(x)))) {
+         if (Env.make != Env.yoke)
+            ArenaRef((any)(Env.make - 1), y);
          do
             Env.make = &cdr(*Env.make);
          while (isCell(*Env.make));
+      }
    while (isCell(x = cdr(x)));
    return y;
 }
@@ -321,7 +326,10 @@ any doLink(any x) {
    x = cdr(x);
    do {
       y = EVAL(car(x));
-      Env.make = &cdr(*Env.make = cons(y, Nil));
+      *Env.make = cons(y, Nil);
+      if (Env.make != Env.yoke)
+         ArenaRef((any)(Env.make - 1), *Env.make);
+      Env.make = &cdr(*Env.make);
    } while (isCell(x = cdr(x)));
    return y;
 }
@@ -362,11 +370,11 @@ any doCopy(any x) {
 }
 
 // (mix 'lst num|'any ..) -> lst
-any doMix(any x) {
-   any y;
+any doMix(any ex) {
+   any x, y;
    cell c1, c2;
 
-   x = cdr(x);
+   x = cdr(ex);
    if (!isCell(data(c1) = EVAL(car(x))) && !isNil(data(c1)))
       return data(c1);
    if (!isCell(x = cdr(x)))
@@ -374,11 +382,11 @@ any doMix(any x) {
    Save(c1);
    Push(c2,
       y = cons(
-         isNum(car(x))? car(nth((int)unBox(car(x)),data(c1))) : EVAL(car(x)),
+         isNum(car(x))? car(nth((int)xNum(ex,car(x)),data(c1))) : EVAL(car(x)),
          Nil ) );
    while (isCell(x = cdr(x)))
       y = cdr(y) = cons(
-         isNum(car(x))? car(nth((int)unBox(car(x)),data(c1))) : EVAL(car(x)),
+         isNum(car(x))? car(nth((int)xNum(ex,car(x)),data(c1))) : EVAL(car(x)),
          Nil );
    drop(c1);
    return data(c2);
@@ -977,11 +985,12 @@ any doSect(any x) {
    x = cdr(x),  Push(c2, EVAL(car(x)));
    Push(c3, x = Nil);
    while (isCell(data(c1))) {
-      if (member(car(data(c1)), data(c2)))
+      if (member(car(data(c1)), data(c2))) {
          if (isNil(x))
             x = data(c3) = cons(car(data(c1)), Nil);
          else
             x = cdr(x) = cons(car(data(c1)), Nil);
+      }
       data(c1) = cdr(data(c1));
    }
    drop(c1);
@@ -996,11 +1005,12 @@ any doDiff(any x) {
    x = cdr(x),  Push(c2, EVAL(car(x)));
    Push(c3, x = Nil);
    while (isCell(data(c1))) {
-      if (!member(car(data(c1)), data(c2)))
+      if (!member(car(data(c1)), data(c2))) {
          if (isNil(x))
             x = data(c3) = cons(car(data(c1)), Nil);
          else
             x = cdr(x) = cons(car(data(c1)), Nil);
+      }
       data(c1) = cdr(data(c1));
    }
    drop(c1);
@@ -1054,8 +1064,8 @@ any doLength(any x) {
    any y;
 
    if (isNum(x = EVAL(cadr(x)))) {
-      char buf[BITS/2];
-      return box(bufNum(buf, unBox(x)));
+      char buf[numSize(x)];
+      return box(bufBig(buf, x));
    }
    if (isSym(x)) {
       if (isNil(x))
@@ -1359,11 +1369,12 @@ static any uniFill(any x) {
 }
 
 // (prove 'lst ['lst]) -> lst
-any doProve(any x) {
+any doProve(any ex) {
    int i;
+   any x;
    cell *envSave, *nlSave, at, q, dbg, env, n, nl, alt, tp1, tp2, e;
 
-   x = cdr(x);
+   x = cdr(ex);
    if (!isCell(data(q) = EVAL(car(x))))
       return Nil;
    Save(q);
@@ -1408,7 +1419,7 @@ any doProve(any x) {
                               cons(data(tp1), cons(data(tp2),data(e))) ) ) ),
                      car(data(q)) );
             data(nl) = cons(data(n), data(nl));
-            data(n) = (any)(num(data(n)) + 4);
+            data(n) = numInc(data(n));
             data(tp2) = cons(cdr(data(tp1)), data(tp2));
             data(tp1) = cdar(data(alt));
             data(alt) = Nil;
@@ -1425,7 +1436,7 @@ any doProve(any x) {
       }
       else if (isNum(caar(x))) {
          data(e) = EVAL(cdar(x));
-         for (i = unBox(caar(x)), x = data(nl);  --i > 0;)
+         for (i = xNum(ex,caar(x)), x = data(nl);  --i > 0;)
             x = cdr(x);
          data(nl) = cons(car(x), data(nl));
          data(tp2) = cons(cdr(data(tp1)), data(tp2));
@@ -1463,15 +1474,15 @@ any doProve(any x) {
 }
 
 // (-> sym [num]) -> any
-any doArrow(any x) {
+any doArrow(any ex) {
    int i;
    any y;
 
-   if (!isNum(caddr(x)))
-      return lookup(car(data(*Pnl)), cadr(x));
-   for (i = unBox(caddr(x)), y = data(*Pnl);  --i > 0;)
+   if (!isNum(caddr(ex)))
+      return lookup(car(data(*Pnl)), cadr(ex));
+   for (i = xNum(ex,caddr(ex)), y = data(*Pnl);  --i > 0;)
       y = cdr(y);
-   return lookup(car(y), cadr(x));
+   return lookup(car(y), cadr(ex));
 }
 
 // (unify 'any) -> lst
@@ -1487,72 +1498,54 @@ any doUnify(any x) {
    return Nil;
 }
 
-/* List Merge Sort: Bill McDaniel, DDJ Jun99 */
-// (sort 'lst) -> lst
-any doSort(any x) {
-   int i;
-   any p, in[2], out[2], last;
-   any *tail[2];
-
-   x = cdr(x);
-   if (!isCell(out[0] = EVAL(car(x))))
-      return out[0];
+/* True if 'x' sorts before 'y' */
+static bool before(any ex, any foo, int sgn, any x, any y, cell *c) {
+   if (sgn)
+      return sgn * compare(x,y) < 0;
+   data(c[0]) = x,  data(c[1]) = y;
+   return !isNil(apply(ex, foo, NO, 2, c));
+}
 
-   out[1] = Nil;
+/* Bottom-up list merge sort: Simon Tatham, 2001 */
+// (sort 'lst ['fun]) -> lst
+any doSort(any ex) {
+   any x, e, tail;
+   int n, k, psize, qsize, sgn;
+   cell c1, foo, p, q, arg[2];
 
-   do {
-      in[0] = out[0];
-      in[1] = out[1];
-
-      i  =  isCell(in[1])  &&  compare(in[0], in[1]) >= 0;
-      if (isCell(p = in[i]))
-         in[i] = cdr(in[i]);
-      out[0] = p;
-      tail[0] = &cdr(p);
-      last = out[0];
-      cdr(p) = Nil;
-      i = 0;
-      out[1] = Nil;
-      tail[1] = &out[1];
-
-      while (isCell(in[0]) || isCell(in[1])) {
-         if (!isCell(in[1])) {
-            if (isCell(p = in[0]))
-               in[0] = cdr(in[0]);
-            if (compare(p,last) < 0)
-               i = 1-i;
-         }
-         else if (!isCell(in[0])) {
-            p = in[1],  in[1] = cdr(in[1]);
-            if (compare(p,last) < 0)
-               i = 1-i;
-         }
-         else if (compare(in[0],last) < 0) {
-            if (compare(in[1],last) >= 0)
-               p = in[1],  in[1] = cdr(in[1]);
-            else {
-               if (compare(in[0],in[1]) < 0)
-                  p = in[0],  in[0] = cdr(in[0]);
-               else
-                  p = in[1],  in[1] = cdr(in[1]);
-               i = 1-i;
-            }
-         }
-         else {
-            if (compare(in[1],last) < 0)
-               p = in[0],  in[0] = cdr(in[0]);
-            else {
-               if (compare(in[0],in[1]) < 0)
-                  p = in[0],  in[0] = cdr(in[0]);
-               else
-                  p = in[1],  in[1] = cdr(in[1]);
-            }
+   x = cdr(ex);
+   if (!isCell(data(c1) = EVAL(car(x))))
+      return data(c1);
+   Save(c1);
+   Push(foo, EVAL(cadr(x)));
+   e = isSymb(data(foo))? val(data(foo)) : data(foo);
+   sgn = isNil(data(foo)) || e == boxSubr(doLt)? 1 : e == boxSubr(doGt)? -1 : 0;
+   Push(p, Nil),  Push(q, Nil);
+   for (n = 1;;  n *= 2) {
+      data(p) = data(c1),  data(c1) = tail = Nil;
+      for (k = 0;  isCell(data(p));  ++k) {
+         data(q) = data(p);
+         for (psize = 0;  psize < n && isCell(data(q));  ++psize)
+            data(q) = cdr(data(q));
+         qsize = n;
+         while (psize > 0  ||  (qsize > 0 && isCell(data(q)))) {
+            if (psize == 0  ||  (qsize > 0 && isCell(data(q)) &&
+                     before(ex, data(foo), sgn, car(data(q)), car(data(p)), arg)) )
+               e = data(q),  data(q) = cdr(e),  --qsize;
+            else
+               e = data(p),  data(p) = cdr(e),  --psize;
+            if (isNil(tail))
+               data(c1) = e;
+            else
+               cdr(tail) = e;
+            tail = e;
          }
-         *tail[i] = p;
-         tail[i] = &cdr(p);
-         cdr(p) = Nil;
-         last = p;
+         data(p) = data(q);
       }
-   } while (isCell(out[1]));
-   return out[0];
+      cdr(tail) = Nil;
+      if (k <= 1)
+         break;
+   }
+   drop(c1);
+   return data(c1);
 }
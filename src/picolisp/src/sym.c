@@ -4,6 +4,9 @@
 
 #include "pico.h"
 
+/* Last name word, kept in the old short number encoding */
+#define nameBox(n)      ((any)(num(n)<<2|2))
+
 static byte Ascii6[] = {
    0,  2,  2,  2,  2,  2,  2,   2,   2,   2,   2,   2,   2,   2,   2,   2,
    2,  2,  2,  2,  2,  2,  2,   2,   2,   2,   2,   2,   2,   2,   2,   2,
@@ -112,6 +115,25 @@ int getByte(int *i, word *p, any *q) {
    return Ascii7[c];
 }
 
+/* Decode the bytes up to the end of the current word, return the count */
+int getBytes(byte *buf, int *i, word *p, any *q) {
+   int c, j, n;
+   word w;
+
+   for (j = *i, w = *p, n = 0;  j >= 7;  ++n) {
+      if (w & 1)
+         c = w & 127,  w >>= 7,  j -= 7;
+      else
+         c = w & 63,  w >>= 6,  j -= 6;
+      if (!(buf[n] = Ascii7[c]))
+         break;
+   }
+   *i = j,  *p = w;
+   if (j < 7  &&  (buf[n] = getByte(i, p, q)))
+      ++n;
+   return n;
+}
+
 any mkTxt(int c) {return txt(Ascii6[c & 127]);}
 
 any mkChar(int c) {
@@ -140,10 +162,10 @@ void putByte(int c, int *i, word *p, any *q, cell *cp) {
       *p |= (word)c << *i;
    if (*i + d  > BITS) {
       if (*q)
-         *q = val(*q) = consName(*p, Zero);
+         *q = val(*q) = consName(*p, nameBox(0));
       else {
          Push(*cp, consSym(NULL,0));
-         tail(data(*cp)) = *q = consName(*p, Zero);
+         tail(data(*cp)) = *q = consName(*p, nameBox(0));
       }
       *p = c >> BITS - *i;
       *i -= BITS;
@@ -153,12 +175,12 @@ void putByte(int c, int *i, word *p, any *q, cell *cp) {
 
 any popSym(int i, word n, any q, cell *cp) {
    if (q) {
-      val(q) = i <= (BITS-2)? box(n) : consName(n, Zero);
+      val(q) = i <= (BITS-2)? nameBox(n) : consName(n, nameBox(0));
       return Pop(*cp);
    }
    if (i > BITS-1) {
       Push(*cp, consSym(NULL,0));
-      tail(data(*cp)) = consName(n, Zero);
+      tail(data(*cp)) = consName(n, nameBox(0));
       return Pop(*cp);
    }
    return consSym(NULL,n);
@@ -190,210 +212,113 @@ int symBytes(any x) {
    return cnt;
 }
 
-any isIntern(any nm, any tree[2]) {
-   any x, y, z;
-   long n;
+/* Compare symbol names */
+static int cmpName(any x, any y) {
+   if (isTxt(x))
+      return x == y? 0 : (word)x < (word)y? -1 : +1;
+   for (;;) {
+      if (tail(x) != tail(y))
+         return (word)tail(x) < (word)tail(y)? -1 : +1;
+      x = val(x),  y = val(y);
+      if (isNum(x))
+         return !isNum(y)? -1 : x == y? 0 : (word)x < (word)y? -1 : +1;
+      if (isNum(y))
+         return +1;
+   }
+}
 
-   if (isTxt(nm)) {
-      for (x = tree[0];  isCell(x);) {
-         if ((n = (word)nm - (word)name(car(x))) == 0)
-            return car(x);
-         x = n<0? cadr(x) : cddr(x);
-      }
+/* Treap priority of a name */
+static word hashName(any x) {
+   word h;
+
+   if (isTxt(x))
+      return (word)x * HASH_MUL;
+   for (h = 0;  !isNum(x);  x = val(x))
+      h = (h ^ (word)tail(x)) * HASH_MUL;
+   return (h ^ (word)x) * HASH_MUL;
+}
+
+/* Rotate the left (or right) child of '*p' into its place */
+void rotate(any *p, bool left) {
+   any x = *p,  y;
+
+   if (left) {
+      y = cadr(x);
+      if (!isCell(cdr(y)))
+         cdr(y) = consHeap(Nil,Nil);
+      cadr(x) = cddr(y),  cddr(y) = x;
    }
    else {
-      for (x = tree[1];  isCell(x);) {
-         y = nm,  z = name(car(x));
-         for (;;) {
-            if ((n = (word)tail(y) - (word)tail(z)) != 0) {
-               x = n<0? cadr(x) : cddr(x);
-               break;
-            }
-            y = val(y),  z = val(z);
-            if (isNum(y)) {
-               if (y == z)
-                  return car(x);
-               x = isNum(z) && y>z? cddr(x) : cadr(x);
-               break;
-            }
-            if (isNum(z)) {
-               x = cddr(x);
-               break;
-            }
-         }
-      }
+      y = cddr(x);
+      if (!isCell(cdr(y)))
+         cdr(y) = consHeap(Nil,Nil);
+      cddr(x) = cadr(y),  cadr(y) = x;
+   }
+   *p = y;
+}
+
+any isIntern(any nm, any tree[2]) {
+   any x;
+   int n;
+
+   for (x = tree[isTxt(nm)? 0 : 1];  isCell(x);) {
+      if ((n = cmpName(nm, name(car(x)))) == 0)
+         return car(x);
+      x = n<0? cadr(x) : cddr(x);
    }
    return NULL;
 }
 
 any intern(any sym, any tree[2]) {
-   any nm, x, y, z;
-   long n;
+   any nm, x, *p, *path[BITS];
+   int n, d;
+   word h;
+   cell c1;
 
    if ((nm = name(sym)) == txt(0))
       return sym;
-   if (isTxt(nm)) {
-      if (!isCell(x = tree[0])) {
-         tree[0] = cons(sym, Nil);
-         return sym;
-      }
-      for (;;) {
-         if ((n = (word)nm - (word)name(car(x))) == 0)
-            return car(x);
-         if (!isCell(cdr(x))) {
-            cdr(x) = n<0? cons(cons(sym,Nil), Nil) : cons(Nil, cons(sym,Nil));
-            return sym;
-         }
-         if (n < 0) {
-            if (isCell(cadr(x)))
-               x = cadr(x);
-            else {
-               cadr(x) = cons(sym, Nil);
-               return sym;
-            }
-         }
-         else {
-            if (isCell(cddr(x)))
-               x = cddr(x);
-            else {
-               cddr(x) = cons(sym, Nil);
-               return sym;
-            }
-         }
-      }
-   }
-   else {
-      if (!isCell(x = tree[1])) {
-         tree[1] = cons(sym, Nil);
-         return sym;
-      }
-      for (;;) {
-         y = nm,  z = name(car(x));
-         while ((n = (word)tail(y) - (word)tail(z)) == 0) {
-            y = val(y),  z = val(z);
-            if (isNum(y)) {
-               if (y == z)
-                  return car(x);
-               n = isNum(z)? y-z : -1;
-               break;
-            }
-            if (isNum(z)) {
-               n = +1;
-               break;
-            }
-         }
-         if (!isCell(cdr(x))) {
-            cdr(x) = n<0? cons(cons(sym,Nil), Nil) : cons(Nil, cons(sym,Nil));
-            return sym;
-         }
-         if (n < 0) {
-            if (isCell(cadr(x)))
-               x = cadr(x);
-            else {
-               cadr(x) = cons(sym, Nil);
-               return sym;
-            }
-         }
-         else {
-            if (isCell(cddr(x)))
-               x = cddr(x);
-            else {
-               cddr(x) = cons(sym, Nil);
-               return sym;
-            }
-         }
+   for (p = &tree[isTxt(nm)? 0 : 1],  d = 0;  isCell(x = *p);  ++d) {
+      if ((n = cmpName(nm, name(car(x)))) == 0)
+         return car(x);
+      if (d < BITS)
+         path[d] = p;
+      if (!isCell(cdr(x))) {
+         Push(c1, sym);
+         cdr(x) = consHeap(Nil,Nil);
+         drop(c1);
       }
+      p = n<0? &cadr(x) : &cddr(x);
    }
+   if (tree == Intern  &&  (x = romSym(sym)))  // Built-in not used so far
+      sym = x;
+   *p = x = consHeap(sym, Nil);
+   if (d <= BITS)
+      for (h = hashName(nm);  --d >= 0  &&  hashName(name(car(*path[d]))) < h;)
+         rotate(path[d], x == cadr(*path[d]));
+   return sym;
 }
 
 void unintern(any sym, any tree[2]) {
-   any nm, x, y, z, *p;
-   long n;
+   any nm, x, *p;
+   int n;
 
    if ((nm = name(sym)) == txt(0))
       return;
-   if (isTxt(nm)) {
-      if (!isCell(x = tree[0]))
+   for (p = &tree[isTxt(nm)? 0 : 1];;) {
+      if (!isCell(x = *p))
          return;
-      p = &tree[0];
-      for (;;) {
-         if ((n = (word)nm - (word)name(car(x))) == 0) {
-            if (car(x) == sym) {
-               if (!isCell(cadr(x)))
-                  *p = cddr(x);
-               else if (!isCell(y = cddr(x)))
-                  *p = cadr(x);
-               else if (!isCell(z = cadr(y)))
-                  car(x) = car(y),  cddr(x) = cddr(y);
-               else {
-                  while (isCell(cadr(z)))
-                     z = cadr(y = z);
-                  car(x) = car(z),  cadr(y) = cddr(z);
-               }
-            }
-            return;
-         }
-         if (!isCell(cdr(x)))
-            return;
-         if (n < 0) {
-            if (!isCell(cadr(x)))
-               return;
-            x = *(p = &cadr(x));
-         }
-         else {
-            if (!isCell(cddr(x)))
-               return;
-            x = *(p = &cddr(x));
-         }
-      }
+      if ((n = cmpName(nm, name(car(x)))) == 0)
+         break;
+      p = n<0? &cadr(x) : &cddr(x);
    }
-   else {
-      if (!isCell(x = tree[1]))
-         return;
-      p = &tree[1];
-      for (;;) {
-         y = nm,  z = name(car(x));
-         while ((n = (word)tail(y) - (word)tail(z)) == 0) {
-            y = val(y),  z = val(z);
-            if (isNum(y)) {
-               if (y == z) {
-                  if (car(x) == sym) {
-                     if (!isCell(cadr(x)))
-                        *p = cddr(x);
-                     else if (!isCell(y = cddr(x)))
-                        *p = cadr(x);
-                     else if (!isCell(z = cadr(y)))
-                        car(x) = car(y),  cddr(x) = cddr(y);
-                     else {
-                        while (isCell(cadr(z)))
-                           z = cadr(y = z);
-                        car(x) = car(z),  cadr(y) = cddr(z);
-                     }
-                  }
-                  return;
-               }
-               n = isNum(z)? y-z : -1;
-               break;
-            }
-            if (isNum(z)) {
-               n = +1;
-               break;
-            }
-         }
-         if (!isCell(cdr(x)))
-            return;
-         if (n < 0) {
-            if (!isCell(cadr(x)))
-               return;
-            x = *(p = &cadr(x));
-         }
-         else {
-            if (!isCell(cddr(x)))
-               return;
-            x = *(p = &cddr(x));
-         }
-      }
+   if (car(x) != sym)
+      return;
+   while (isCell(cadr(x)) && isCell(cddr(x))) {
+      n = hashName(name(caadr(x))) > hashName(name(caddr(x)));
+      rotate(p, n);
+      p = n? &cddr(*p) : &cadr(*p);
    }
+   *p = isCell(cadr(x))? cadr(x) : cddr(x);
 }
 
 /* Get symbol name */
@@ -518,7 +443,10 @@ any doAll(any x) {
    cell c1;
 
    x = cdr(x);
-   p = isNil(EVAL(car(x)))? Intern : Transient;
+   if (isNil(EVAL(car(x))))
+      romAll(),  p = Intern;
+   else
+      p = Transient;
    Push(c1, Nil);
    if (isCell(p[1]))
       all(p[1], &c1);
@@ -610,9 +538,9 @@ void pack(any x, int *i, word *p, any *q, cell *cp) {
          pack(car(x), i, p, q, cp);
       while (isCell(x = cdr(x)));
    if (isNum(x)) {
-      char buf[BITS/2], *b = buf;
+      char buf[numSize(x)], *b = buf;
 
-      bufNum(buf, unBox(x));
+      bufBig(buf, x);
       do
          putByte(*b++, i, p, q, cp);
       while (*b);
@@ -752,6 +680,8 @@ any doSet(any ex) {
       NeedVar(ex,data(c1));
       CheckVar(ex,data(c1));
       val(data(c1)) = EVAL(car(x)),  x = cdr(x);
+      ArenaRef(data(c1), val(data(c1)));
+      flushClass(data(c1));
       drop(c1);
    } while (isCell(x));
    return val(data(c1));
@@ -767,6 +697,8 @@ any doSetq(any ex) {
       NeedVar(ex,y);
       CheckVar(ex,y);
       val(y) = EVAL(car(x));
+      ArenaRef(y, val(y));
+      flushClass(y);
    } while (isCell(x = cdr(x)));
    return val(y);
 }
@@ -785,6 +717,8 @@ any doXchg(any ex) {
       NeedVar(ex,y);
       CheckVar(ex,y);
       z = val(data(c1)),  val(data(c1)) = val(y),  val(y) = z;
+      ArenaRef(data(c1), val(data(c1))),  ArenaRef(y, z);
+      flushClass(data(c1)),  flushClass(y);
       drop(c1);
    } while (isCell(x));
    return z;
@@ -797,6 +731,7 @@ any doOn(any ex) {
       NeedVar(ex,car(x));
       CheckVar(ex,car(x));
       val(car(x)) = T;
+      flushClass(car(x));
    } while (isCell(x = cdr(x)));
    return T;
 }
@@ -808,6 +743,7 @@ any doOff(any ex) {
       NeedVar(ex,car(x));
       CheckVar(ex,car(x));
       val(car(x)) = Nil;
+      flushClass(car(x));
    } while (isCell(x = cdr(x)));
    return Nil;
 }
@@ -821,6 +757,7 @@ any doOnOff(any ex) {
       NeedVar(ex,car(x));
       CheckVar(ex,car(x));
       y = val(car(x)) = isNil(val(car(x)))? T : Nil;
+      flushClass(car(x));
    } while (isCell(x = cdr(x)));
    return y;
 }
@@ -832,6 +769,7 @@ any doZero(any ex) {
       NeedVar(ex,car(x));
       CheckVar(ex,car(x));
       val(car(x)) = Zero;
+      flushClass(car(x));
    } while (isCell(x = cdr(x)));
    return Zero;
 }
@@ -843,6 +781,7 @@ any doOne(any ex) {
       NeedVar(ex,car(x));
       CheckVar(ex,car(x));
       val(car(x)) = One;
+      flushClass(car(x));
    } while (isCell(x = cdr(x)));
    return One;
 }
@@ -857,7 +796,7 @@ any doDefault(any ex) {
       NeedVar(ex,y);
       CheckVar(ex,y);
       if (isNil(val(y)))
-         val(y) = EVAL(car(x));
+         val(y) = EVAL(car(x)),  ArenaRef(y, val(y)),  flushClass(y);
    } while (isCell(x = cdr(x)));
    return val(y);
 }
@@ -874,6 +813,8 @@ any doPush(any ex) {
    val(data(c1)) = cons(y = EVAL(car(x)), val(data(c1)));
    while (isCell(x = cdr(x)))
       val(data(c1)) = cons(y = EVAL(car(x)), val(data(c1)));
+   ArenaRef(data(c1), val(data(c1)));
+   flushClass(data(c1));
    drop(c1);
    return y;
 }
@@ -892,6 +833,8 @@ any doPush1(any ex) {
    while (isCell(x = cdr(x)))
       if (!member(y = EVAL(car(x)), val(data(c1))))
          val(data(c1)) = cons(y, val(data(c1)));
+   ArenaRef(data(c1), val(data(c1)));
+   flushClass(data(c1));
    drop(c1);
    return y;
 }
@@ -906,6 +849,8 @@ any doPop(any ex) {
    if (!isCell(y = val(x)))
       return y;
    val(x) = cdr(y);
+   ArenaRef(x, cdr(y));
+   flushClass(x);
    return car(y);
 }
 
@@ -924,6 +869,8 @@ any doCut(any ex) {
       Push(c2, y = cons(car(val(data(c1))), Nil));
       while (isCell(val(data(c1)) = cdr(val(data(c1)))) && --n)
          y = cdr(y) = cons(car(val(data(c1))), Nil);
+      ArenaRef(data(c1), val(data(c1)));
+      flushClass(data(c1));
       drop(c1);
       return data(c2);
    }
@@ -941,15 +888,21 @@ any doDel(any ex) {
    CheckVar(ex,data(c2));
    if (isCell(x = val(data(c2)))) {
       if (equal(data(c1), car(x))) {
+         val(data(c2)) = cdr(x);
+         ArenaRef(data(c2), cdr(x));
+         flushClass(data(c2));
          drop(c1);
-         return val(data(c2)) = cdr(x);
+         return val(data(c2));
       }
       Push(c3, y = cons(car(x), Nil));
       while (isCell(x = cdr(x))) {
          if (equal(data(c1), car(x))) {
             cdr(y) = cdr(x);
+            val(data(c2)) = data(c3);
+            ArenaRef(data(c2), data(c3));
+            flushClass(data(c2));
             drop(c1);
-            return val(data(c2)) = data(c3);
+            return val(data(c2));
          }
          y = cdr(y) = cons(car(x), Nil);
       }
@@ -968,12 +921,13 @@ any doQueue(any ex) {
    CheckVar(ex,data(c1));
    x = cdr(x),  x = EVAL(car(x));
    if (!isCell(y = val(data(c1))))
-      val(data(c1)) = cons(x,Nil);
+      val(data(c1)) = cons(x,Nil),  ArenaRef(data(c1), val(data(c1)));
    else {
       while (isCell(cdr(y)))
          y = cdr(y);
-      cdr(y) = cons(x,Nil);
+      cdr(y) = cons(x,Nil),  ArenaRef(y, cdr(y));
    }
+   flushClass(data(c1));
    drop(c1);
    return x;
 }
@@ -989,13 +943,15 @@ any doFifo(any ex) {
    if (isCell(x = cdr(x))) {
       y = EVAL(car(x));
       if (isCell(z = val(data(c1))))
-         val(data(c1)) = z = cdr(z) = cons(y,cdr(z));
+         cdr(z) = cons(y,cdr(z)),  ArenaRef(z, cdr(z)),  val(data(c1)) = z = cdr(z);
       else {
          z = val(data(c1)) = cons(y,Nil);
          cdr(z) = z;
       }
       while (isCell(x = cdr(x)))
-         val(data(c1)) = z = cdr(z) = cons(y = EVAL(car(x)), cdr(z));
+         cdr(z) = cons(y = EVAL(car(x)), cdr(z)),  ArenaRef(z, cdr(z)),  val(data(c1)) = z = cdr(z);
+      ArenaRef(data(c1), z);
+      flushClass(data(c1));
    }
    else if (!isCell(z = val(data(c1))))
       y = Nil;
@@ -1006,8 +962,9 @@ any doFifo(any ex) {
       }
       else {
          y = cadr(z);
-         cdr(z) = cddr(z);
+         cdr(z) = cddr(z),  ArenaRef(z, cdr(z));
       }
+      flushClass(data(c1));
    }
    drop(c1);
    return y;
@@ -1021,12 +978,23 @@ static void idx(any x, cell *p) {
       idx(cadr(x), p);
 }
 
-// (idx 'var 'any 'flg) -> lst
-// (idx 'var 'any) -> lst
-// (idx 'var) -> lst
-any doIdx(any ex) {
-   any x, y, z, *p;
-   int flg, n;
+/* Treap priority of an index node */
+static word prio(any x) {
+   word h = (word)x * HASH_MUL;
+
+   return (h ^ h >> BITS/2) * HASH_MUL;
+}
+
+/* Rotate the new node 'x' up to its priority */
+static void balance(any **path, int d, any x) {
+   if (d <= BITS)
+      while (--d >= 0  &&  prio(*path[d]) < prio(x))
+         rotate(path[d], x == cadr(*path[d]));
+}
+
+static any treeIdx(any ex, bool bal) {
+   any x, y, z, *p, *path[BITS];
+   int flg, n, d;
    cell c1, c2;
 
    x = cdr(ex),  Push(c1, EVAL(car(x)));
@@ -1043,12 +1011,14 @@ any doIdx(any ex) {
    flg = !isCell(cdr(x))? 0 : isNil(EVAL(cadr(x)))? -1 : +1;
    if (!isCell(x = val(data(c1)))) {
       if (flg > 0)
-         val(data(c1)) = cons(data(c2),Nil);
+         val(data(c1)) = consHeap(data(c2),Nil),  ArenaRef(val(data(c1)), data(c2));
       drop(c1);
       return Nil;
    }
    p = (any*)data(c1);
-   for (;;) {
+   for (d = 0;;  ++d) {
+      if (d < BITS)
+         path[d] = p;
       if ((n = compare(data(c2), car(x))) == 0) {
          if (flg < 0) {
             if (!isCell(cadr(x)))
@@ -1062,21 +1032,29 @@ any doIdx(any ex) {
                   z = cadr(y = z);
                car(x) = car(z),  cadr(y) = cddr(z);
             }
+            ArenaRef(x, car(x));
          }
          drop(c1);
          return x;
       }
       if (!isCell(cdr(x))) {
-         if (flg > 0)
+         if (flg > 0) {
             cdr(x) = n < 0?
-               cons(cons(data(c2),Nil), Nil) : cons(Nil, cons(data(c2),Nil));
+               consHeap(consHeap(data(c2),Nil), Nil) : consHeap(Nil, consHeap(data(c2),Nil));
+            ArenaRef(n < 0? cadr(x) : cddr(x), data(c2));
+            if (bal)
+               balance(path, d+1, n < 0? cadr(x) : cddr(x));
+         }
          drop(c1);
          return Nil;
       }
       if (n < 0) {
          if (!isCell(cadr(x))) {
-            if (flg > 0)
-               cadr(x) = cons(data(c2),Nil);
+            if (flg > 0) {
+               cadr(x) = consHeap(data(c2),Nil),  ArenaRef(cadr(x), data(c2));
+               if (bal)
+                  balance(path, d+1, cadr(x));
+            }
             drop(c1);
             return Nil;
          }
@@ -1084,8 +1062,11 @@ any doIdx(any ex) {
       }
       else {
          if (!isCell(cddr(x))) {
-            if (flg > 0)
-               cddr(x) = cons(data(c2),Nil);
+            if (flg > 0) {
+               cddr(x) = consHeap(data(c2),Nil),  ArenaRef(cddr(x), data(c2));
+               if (bal)
+                  balance(path, d+1, cddr(x));
+            }
             drop(c1);
             return Nil;
          }
@@ -1094,6 +1075,16 @@ any doIdx(any ex) {
    }
 }
 
+// (idx 'var 'any 'flg) -> lst
+// (idx 'var 'any) -> lst
+// (idx 'var) -> lst
+any doIdx(any ex) {return treeIdx(ex, NO);}
+
+// (bidx 'var 'any 'flg) -> lst
+// (bidx 'var 'any) -> lst
+// (bidx 'var) -> lst
+any doBidx(any ex) {return treeIdx(ex, YES);}
+
 static any From, To;
 static cell LupCell;
 
@@ -1147,112 +1138,81 @@ any doLup(any x) {
    return Nil;
 }
 
-void put(any x, any key, any val) {
-   any y, z;
+/* Properties found deep in long property lists */
+static struct {any sym, key, cell;} PropCache[1 << PROP_CACHE];
 
-   if (isCell(y = tail(x))) {
-      if (isCell(cdr(y))) {
-         if (key == cddr(y)) {
-            if (isNil(val))
-               tail(x) = car(y);
-            else if (val == T)
-               cdr(y) = key;
-            else
-               cadr(y) = val;
-            return;
-         }
-      }
-      else if (key == cdr(y)) {
-         if (isNil(val))
-            tail(x) = car(y);
-         else if (val != T)
-            cdr(y) = cons(val,key);
-         return;
-      }
-      while (isCell(z = car(y))) {
-         if (isCell(cdr(z))) {
-            if (key == cddr(z)) {
-               if (isNil(val))
-                  car(y) = car(z);
-               else {
-                  if (val == T)
-                     cdr(z) = key;
-                  else
-                     cadr(z) = val;
-                  car(y) = car(z),  car(z) = tail(x),  tail(x) = z;
-               }
-               return;
-            }
-         }
-         else if (key == cdr(z)) {
-            if (isNil(val))
-               car(y) = car(z);
-            else {
-               if (val != T)
-                  cdr(z) = cons(val,key);
-               car(y) = car(z),  car(z) = tail(x),  tail(x) = z;
+#define propHash(x,k)   ((word)(num(x) ^ num(k)) * HASH_MUL >> (BITS - PROP_CACHE))
+#define propKey(z)      (isCell(cdr(z))? cddr(z) : cdr(z))
+
+void flushProp(void) {memset(PropCache, 0, sizeof(PropCache));}
+
+/* Property cell of 'key', or NULL. Does not modify the list. */
+static any propCell(any x, any key) {
+   any z;
+   int n;
+   word i;
+
+   for (z = tail(x), n = PROP_SCAN;  isCell(z);  z = car(z)) {
+      if (key == propKey(z))
+         return z;
+      if (--n == 0) {
+         i = propHash(x,key);
+         if (PropCache[i].sym == x  &&  PropCache[i].key == key)
+            return PropCache[i].cell;
+         while (isCell(z = car(z)))
+            if (key == propKey(z)) {
+               PropCache[i].sym = x,  PropCache[i].key = key,  PropCache[i].cell = z;
+               return z;
             }
+         return NULL;
+      }
+   }
+   return NULL;
+}
+
+void put(any x, any key, any val) {
+   any y, z;
+   word i;
+
+   if (isNil(val)) {
+      for (y = (any)&tail(x);  isCell(z = car(y));  y = z)
+         if (key == propKey(z)) {
+            car(y) = car(z);
+            i = propHash(x,key);
+            if (PropCache[i].sym == x  &&  PropCache[i].key == key)
+               PropCache[i].sym = NULL;
             return;
          }
-         y = z;
+   }
+   else if (z = propCell(x,key)) {
+      if (isCell(cdr(z))) {
+         if (val == T)
+            cdr(z) = key;
+         else
+            cadr(z) = val;
       }
+      else if (val != T)
+         cdr(z) = consHeap(val,key);
    }
-   if (!isNil(val))
-      tail(x) = cons(tail(x), val==T? key : cons(val,key));
+   else
+      tail(x) = consHeap(tail(x), val==T? key : consHeap(val,key));
+   ArenaRef(x, val);
 }
 
 any get(any x, any key) {
-   any y, z;
+   any z;
 
-   if (!isCell(y = tail(x)))
+   if (!(z = propCell(x,key)))
       return Nil;
-   if (!isCell(cdr(y))) {
-      if (key == cdr(y))
-         return T;
-   }
-   else if (key == cddr(y))
-      return cadr(y);
-   while (isCell(z = car(y))) {
-      if (!isCell(cdr(z))) {
-         if (key == cdr(z)) {
-            car(y) = car(z),  car(z) = tail(x),  tail(x) = z;
-            return T;
-         }
-      }
-      else if (key == cddr(z)) {
-         car(y) = car(z),  car(z) = tail(x),  tail(x) = z;
-         return cadr(z);
-      }
-      y = z;
-   }
-   return Nil;
+   return isCell(cdr(z))? cadr(z) : T;
 }
 
 any prop(any x, any key) {
-   any y, z;
+   any y;
 
-   if (isCell(y = tail(x))) {
-      if (!isCell(cdr(y))) {
-         if (key == cdr(y))
-            return key;
-      }
-      else if (key == cddr(y))
-         return cdr(y);
-      while (isCell(z = car(y))) {
-         if (!isCell(cdr(z))) {
-            if (key == cdr(z)) {
-               car(y) = car(z),  car(z) = tail(x),  tail(x) = z;
-               return key;
-            }
-         }
-         else if (key == cddr(z)) {
-            car(y) = car(z),  car(z) = tail(x),  tail(x) = z;
-            return cdr(z);
-         }
-         y = z;
-      }
-   }
-   tail(x) = cons(tail(x), y = cons(Nil,key));
+   if (y = propCell(x,key))
+      return isCell(cdr(y))? cdr(y) : key;
+   tail(x) = consHeap(tail(x), y = consHeap(Nil,key));
    return y;
 }
 
@@ -1276,6 +1236,8 @@ any doPut(any ex) {
    if (data(c2) == Zero) {
       CheckVar(ex,data(c1));
       val(data(c1)) = x = EVAL(car(x));
+      ArenaRef(data(c1), x);
+      flushClass(data(c1));
    }
    else
       put(data(c1), data(c2), x = EVAL(car(x)));
@@ -1360,6 +1322,8 @@ any doSetCol(any ex) {
    if (z == Zero) {
       CheckVar(ex,y);
       val(y) = x = EVAL(car(x));
+      ArenaRef(y, x);
+      flushClass(y);
    }
    else
       put(y, z, x = EVAL(car(x)));
@@ -1423,11 +1387,13 @@ any doPutl(any ex) {
    x = (any)&tail(data(c1));
    while (isCell(car(x)))
       car(x) = caar(x);
+   flushProp();
    for (y = data(c2);  isCell(y);  y = cdr(y))
       if (!isCell(car(y)))
-         car(x) = cons(car(x),car(y));
+         car(x) = consHeap(car(x),car(y));
       else if (!isNil(caar(y)))
-         car(x) = cons(car(x), caar(y)==T? cdar(y) : car(y));
+         car(x) = consHeap(car(x), caar(y)==T? cdar(y) : car(y));
+   ArenaRef(data(c1), data(c2));
    drop(c1);
    return data(c2);
 }
@@ -0,0 +1,312 @@
+/* Built-in functions
+ *
+ * The entries may be in any order. The build runs this file through the
+ * C preprocessor and mksymtab.py, which writes them sorted by name into
+ * symtab.h for the binary search in tab.c.
+ */
+
+#include "platform_conf.h"
+
+PICOLISP_SYMBOLS
+#if defined PICOLISP_PLATFORM_LIBS_ROM
+#  undef _ROM
+#  define _ROM(module)\
+   PICOLISP_MOD_##module
+   PICOLISP_PLATFORM_LIBS_ROM
+#if defined PICOLISP_TARGET_SPECIFIC_LIBS
+   PICOLISP_TARGET_SPECIFIC_LIBS
+#endif
+#endif
+   {doAbs, "abs"},
+   {doAdd, "+"},
+   {doAll, "all"},
+   {doAnd, "and"},
+   {doAny, "any"},
+   {doAppend, "append"},
+   {doApply, "apply"},
+   {doArg, "arg"},
+   {doArgs, "args"},
+   {doArgv, "argv"},
+   {doArrGet, "arr-get"},
+   {doArrLen, "arr-len"},
+   {doArrList, "arr-list"},
+   {doArrNew, "arr-new"},
+   {doArrSet, "arr-set"},
+   {doArrSlice, "arr-slice"},
+   {doArrWrite, "arr-write"},
+   {doArrow, "->"},
+   {doAs, "as"},
+   {doAsoq, "asoq"},
+   {doAssoc, "assoc"},
+   {doAt, "at"},
+   {doAtom, "atom"},
+   {doBidx, "bidx"},
+   {doBind, "bind"},
+   {doBitAnd, "&"},
+   {doBitOr, "|"},
+   {doBitQ, "bit?"},
+   {doBitXor, "x|"},
+   {doBool, "bool"},
+   {doBox, "box"},
+   {doBoxQ, "box?"},
+   {doBreak, "!"},
+   {doBy, "by"},
+   {doBye, "bye"},
+   {doCaaar, "caaar"},
+   {doCaadr, "caadr"},
+   {doCaar, "caar"},
+   {doCadar, "cadar"},
+   {doCadddr, "cadddr"},
+   {doCaddr, "caddr"},
+   {doCadr, "cadr"},
+   {doCar, "car"},
+   {doCase, "case"},
+   {doCatch, "catch"},
+   {doCdaar, "cdaar"},
+   {doCdadr, "cdadr"},
+   {doCdar, "cdar"},
+   {doCddar, "cddar"},
+   {doCddddr, "cddddr"},
+   {doCdddr, "cdddr"},
+   {doCddr, "cddr"},
+   {doCdr, "cdr"},
+   {doChar, "char"},
+   {doChain, "chain"},
+   {doChop, "chop"},
+   {doCirc, "circ"},
+   {doCircQ, "circ?"},
+   {doClip, "clip"},
+   {doCmd, "cmd"},
+   {doCnt, "cnt"},
+   {doCol, ":"},
+   {doCompile, "compile"},
+   {doCon, "con"},
+   {doConc, "conc"},
+   {doCond, "cond"},
+   {doCons, "cons"},
+   {doCopy, "copy"},
+   {doCut, "cut"},
+   {doDate, "date"},
+   {doDe, "de"},
+   {doDec, "dec"},
+   {doDef, "def"},
+   {doDefault, "default"},
+   {doDel, "del"},
+   {doDelete, "delete"},
+   {doDelq, "delq"},
+   {doDiff, "diff"},
+   {doDiv, "/"},
+   {doDm, "dm"},
+   {doDo, "do"},
+   {doE, "e"},
+   {doEnv, "env"},
+   {doEof, "eof"},
+   {doEol, "eol"},
+   {doEq, "=="},
+   {doEq0, "=0"},
+   {doEqT, "=T"},
+   {doEqual, "="},
+   {doEval, "eval"},
+   {doExtra, "extra"},
+   {doExtract, "extract"},
+   {doFifo, "fifo"},
+   {doFill, "fill"},
+   {doFilter, "filter"},
+   {doFin, "fin"},
+   {doFinally, "finally"},
+   {doFind, "find"},
+   {doFish, "fish"},
+   {doFlgQ, "flg?"},
+   {doFlip, "flip"},
+   {doFlush, "flush"},
+   {doFold, "fold"},
+   {doFor, "for"},
+   {doFormat, "format"},
+   {doFrom, "from"},
+   {doFull, "full"},
+   {doFunQ, "fun?"},
+   {doGc, "gc"},
+   {doGcStats, "gc-stats"},
+   {doGcStep, "gc-step"},
+   {doGe, ">="},
+   {doGe0, "ge0"},
+   {doGet, "get"},
+   {doGetl, "getl"},
+   {doGlue, "glue"},
+   {doGt, ">"},
+   {doGt0, "gt0"},
+   {doHead, "head"},
+   {doHeap, "heap"},
+   {doHeapPolicy, "heap-policy"},
+   {doHide, "===="},
+   {doIdx, "idx"},
+   {doIf, "if"},
+   {doIf2, "if2"},
+   {doIfn, "ifn"},
+   {doIn, "in"},
+   {doInc, "inc"},
+   {doIndex, "index"},
+   {doIntern, "intern"},
+   {doIsa, "isa"},
+   {doJob, "job"},
+   {doLast, "last"},
+   {doLe, "<="},
+   {doLe0, "le0"},
+   {doLength, "length"},
+   {doLet, "let"},
+   {doLetQ, "let?"},
+   {doLine, "line"},
+   {doLink, "link"},
+   {doList, "list"},
+   {doLit, "lit"},
+   {doLstQ, "lst?"},
+   {doLoad, "load"},
+   {doLoop, "loop"},
+   {doLowQ, "low?"},
+   {doLowc, "lowc"},
+   {doLt, "<"},
+   {doLt0, "lt0"},
+   {doLup, "lup"},
+   {doMade, "made"},
+   {doMake, "make"},
+   {doMap, "map"},
+   {doMapc, "mapc"},
+   {doMapcan, "mapcan"},
+   {doMapcar, "mapcar"},
+   {doMapcon, "mapcon"},
+   {doMaplist, "maplist"},
+   {doMaps, "maps"},
+   {doMatch, "match"},
+   {doMax, "max"},
+   {doMaxi, "maxi"},
+   {doMember, "member"},
+   {doMemq, "memq"},
+   {doMeta, "meta"},
+   {doMethod, "method"},
+   {doMin, "min"},
+   {doMini, "mini"},
+   {doMix, "mix"},
+   {doMmeq, "mmeq"},
+   {doMul, "*"},
+   {doMulDiv, "*/"},
+   {doName, "name"},
+   {doNand, "nand"},
+   {doNEq, "n=="},
+   {doNEq0, "n0"},
+   {doNEqT, "nT"},
+   {doNEqual, "<>"},
+   {doNeed, "need"},
+   {doNew, "new"},
+   {doNext, "next"},
+   {doNil, "nil"},
+   {doNond, "nond"},
+   {doNor, "nor"},
+   {doNot, "not"},
+   {doNth, "nth"},
+   {doNumQ, "num?"},
+   {doOff, "off"},
+   {doOffset, "offset"},
+   {doOn, "on"},
+   {doOne, "one"},
+   {doOnOff, "onOff"},
+   {doOpt, "opt"},
+   {doOr, "or"},
+   {doOut, "out"},
+   {doPack, "pack"},
+   {doPair, "pair"},
+   {doPass, "pass"},
+   {doPath, "path"},
+   {doPatQ, "pat?"},
+   {doPeek, "peek"},
+   {doPick, "pick"},
+   {doPop, "pop"},
+   {doPreQ, "pre?"},
+   {doPrin, "prin"},
+   {doPrinl, "prinl"},
+   {doPrint, "print"},
+   {doPrintln, "println"},
+   {doPrintsp, "printsp"},
+   {doPrior, "prior"},
+   {doProg, "prog"},
+   {doProg1, "prog1"},
+   {doProg2, "prog2"},
+   {doProp, "prop"},
+   {doPropCol, "::"},
+   {doProve, "prove"},
+   {doPush, "push"},
+   {doPush1, "push1"},
+   {doPut, "put"},
+   {doPutl, "putl"},
+   {doQueue, "queue"},
+   {doQuit, "quit"},
+   {doRand, "rand"},
+   {doRank, "rank"},
+   {doRead, "read"},
+   {doRem, "%"},
+   {doReplace, "replace"},
+   {doRest, "rest"},
+   {doReverse, "reverse"},
+   {doRot, "rot"},
+   {doRun, "run"},
+   {doSave, "save"},
+   {doSect, "sect"},
+   {doSeed, "seed"},
+   {doSeek, "seek"},
+   {doSemicol, ";"},
+   {doSend, "send"},
+   {doSet, "set"},
+   {doSetCol, "=:"},
+   {doSetq, "setq"},
+   {doShift, ">>"},
+   {doSize, "size"},
+   {doSkip, "skip"},
+   {doSort, "sort"},
+   {doSpace, "space"},
+   {doSplit, "split"},
+   {doSpQ, "sp?"},
+   {doSqrt, "sqrt"},
+   {doStack, "stack"},
+   {doState, "state"},
+   {doStem, "stem"},
+   {doStr, "str"},
+   {doStrip, "strip"},
+   {doStrQ, "str?"},
+   {doSub, "-"},
+   {doSum, "sum"},
+   {doSuper, "super"},
+   {doSym, "sym"},
+   {doSymQ, "sym?"},
+   {doT, "t"},
+   {doTail, "tail"},
+   {doText, "text"},
+   {doThrow, "throw"},
+   {doTill, "till"},
+   {doTrace, "$"},
+   {doTrim, "trim"},
+   {doTry, "try"},
+   {doType, "type"},
+   {doUnify, "unify"},
+   {doUnless, "unless"},
+   {doUntil, "until"},
+   {doUp, "up"},
+   {doUppQ, "upp?"},
+   {doUppc, "uppc"},
+   {doUse, "use"},
+   {doVadd, "vadd"},
+   {doVal, "val"},
+   {doVcum, "vcum"},
+   {doVdot, "vdot"},
+   {doVfir, "vfir"},
+   {doVmax, "vmax"},
+   {doVmean, "vmean"},
+   {doVmin, "vmin"},
+   {doVscale, "vscale"},
+   {doWhen, "when"},
+   {doWhile, "while"},
+   {doWith, "with"},
+   {doWithArena, "with-arena"},
+   {doXchg, "xchg"},
+   {doXor, "xor"},
+   {doYoke, "yoke"},
+   {doZap, "zap"},
+   {doZero, "zero"},
@@ -10,288 +10,61 @@
 
 typedef struct symInit {fun code; char *name;} symInit;
 
-static symInit Symbols[] = {
-#if defined PICOLISP_PLATFORM_LIBS_ROM
-#  undef _ROM
-#  define _ROM(module)\
-   PICOLISP_MOD_##module
-   PICOLISP_PLATFORM_LIBS_ROM
-#if defined PICOLISP_TARGET_SPECIFIC_LIBS
-   PICOLISP_TARGET_SPECIFIC_LIBS
-#endif
-#endif
-   {doAbs, "abs"},
-   {doAdd, "+"},
-   {doAll, "all"},
-   {doAnd, "and"},
-   {doAny, "any"},
-   {doAppend, "append"},
-   {doApply, "apply"},
-   {doArg, "arg"},
-   {doArgs, "args"},
-   {doArgv, "argv"},
-   {doArrow, "->"},
-   {doAs, "as"},
-   {doAsoq, "asoq"},
-   {doAssoc, "assoc"},
-   {doAt, "at"},
-   {doAtom, "atom"},
-   {doBind, "bind"},
-   {doBitAnd, "&"},
-   {doBitOr, "|"},
-   {doBitQ, "bit?"},
-   {doBitXor, "x|"},
-   {doBool, "bool"},
-   {doBox, "box"},
-   {doBoxQ, "box?"},
-   {doBreak, "!"},
-   {doBy, "by"},
-   {doBye, "bye"},
-   {doCaaar, "caaar"},
-   {doCaadr, "caadr"},
-   {doCaar, "caar"},
-   {doCadar, "cadar"},
-   {doCadddr, "cadddr"},
-   {doCaddr, "caddr"},
-   {doCadr, "cadr"},
-   {doCar, "car"},
-   {doCase, "case"},
-   {doCatch, "catch"},
-   {doCdaar, "cdaar"},
-   {doCdadr, "cdadr"},
-   {doCdar, "cdar"},
-   {doCddar, "cddar"},
-   {doCddddr, "cddddr"},
-   {doCdddr, "cdddr"},
-   {doCddr, "cddr"},
-   {doCdr, "cdr"},
-   {doChar, "char"},
-   {doChain, "chain"},
-   {doChop, "chop"},
-   {doCirc, "circ"},
-   {doCircQ, "circ?"},
-   {doClip, "clip"},
-   {doCmd, "cmd"},
-   {doCnt, "cnt"},
-   {doCol, ":"},
-   {doCon, "con"},
-   {doConc, "conc"},
-   {doCond, "cond"},
-   {doCons, "cons"},
-   {doCopy, "copy"},
-   {doCut, "cut"},
-   {doDate, "date"},
-   {doDe, "de"},
-   {doDec, "dec"},
-   {doDef, "def"},
-   {doDefault, "default"},
-   {doDel, "del"},
-   {doDelete, "delete"},
-   {doDelq, "delq"},
-   {doDiff, "diff"},
-   {doDiv, "/"},
-   {doDm, "dm"},
-   {doDo, "do"},
-   {doE, "e"},
-   {doEnv, "env"},
-   {doEof, "eof"},
-   {doEol, "eol"},
-   {doEq, "=="},
-   {doEq0, "=0"},
-   {doEqT, "=T"},
-   {doEqual, "="},
-   {doEval, "eval"},
-   {doExtra, "extra"},
-   {doExtract, "extract"},
-   {doFifo, "fifo"},
-   {doFill, "fill"},
-   {doFilter, "filter"},
-   {doFin, "fin"},
-   {doFinally, "finally"},
-   {doFind, "find"},
-   {doFish, "fish"},
-   {doFlgQ, "flg?"},
-   {doFlip, "flip"},
-   {doFlush, "flush"},
-   {doFold, "fold"},
-   {doFor, "for"},
-   {doFormat, "format"},
-   {doFrom, "from"},
-   {doFull, "full"},
-   {doFunQ, "fun?"},
-   {doGc, "gc"},
-   {doGe, ">="},
-   {doGe0, "ge0"},
-   {doGet, "get"},
-   {doGetl, "getl"},
-   {doGlue, "glue"},
-   {doGt, ">"},
-   {doGt0, "gt0"},
-   {doHead, "head"},
-   {doHeap, "heap"},
-   {doHide, "===="},
-   {doIdx, "idx"},
-   {doIf, "if"},
-   {doIf2, "if2"},
-   {doIfn, "ifn"},
-   {doIn, "in"},
-   {doInc, "inc"},
-   {doIndex, "index"},
-   {doIntern, "intern"},
-   {doIsa, "isa"},
-   {doJob, "job"},
-   {doLast, "last"},
-   {doLe, "<="},
-   {doLe0, "le0"},
-   {doLength, "length"},
-   {doLet, "let"},
-   {doLetQ, "let?"},
-   {doLine, "line"},
-   {doLink, "link"},
-   {doList, "list"},
-   {doLit, "lit"},
-   {doLstQ, "lst?"},
-   {doLoad, "load"},
-   {doLoop, "loop"},
-   {doLowQ, "low?"},
-   {doLowc, "lowc"},
-   {doLt, "<"},
-   {doLt0, "lt0"},
-   {doLup, "lup"},
-   {doMade, "made"},
-   {doMake, "make"},
-   {doMap, "map"},
-   {doMapc, "mapc"},
-   {doMapcan, "mapcan"},
-   {doMapcar, "mapcar"},
-   {doMapcon, "mapcon"},
-   {doMaplist, "maplist"},
-   {doMaps, "maps"},
-   {doMatch, "match"},
-   {doMax, "max"},
-   {doMaxi, "maxi"},
-   {doMember, "member"},
-   {doMemq, "memq"},
-   {doMeta, "meta"},
-   {doMethod, "method"},
-   {doMin, "min"},
-   {doMini, "mini"},
-   {doMix, "mix"},
-   {doMmeq, "mmeq"},
-   {doMul, "*"},
-   {doMulDiv, "*/"},
-   {doName, "name"},
-   {doNand, "nand"},
-   {doNEq, "n=="},
-   {doNEq0, "n0"},
-   {doNEqT, "nT"},
-   {doNEqual, "<>"},
-   {doNeed, "need"},
-   {doNew, "new"},
-   {doNext, "next"},
-   {doNil, "nil"},
-   {doNond, "nond"},
-   {doNor, "nor"},
-   {doNot, "not"},
-   {doNth, "nth"},
-   {doNumQ, "num?"},
-   {doOff, "off"},
-   {doOffset, "offset"},
-   {doOn, "on"},
-   {doOne, "one"},
-   {doOnOff, "onOff"},
-   {doOpt, "opt"},
-   {doOr, "or"},
-   {doOut, "out"},
-   {doPack, "pack"},
-   {doPair, "pair"},
-   {doPass, "pass"},
-   {doPath, "path"},
-   {doPatQ, "pat?"},
-   {doPeek, "peek"},
-   {doPick, "pick"},
-   {doPop, "pop"},
-   {doPreQ, "pre?"},
-   {doPrin, "prin"},
-   {doPrinl, "prinl"},
-   {doPrint, "print"},
-   {doPrintln, "println"},
-   {doPrintsp, "printsp"},
-   {doPrior, "prior"},
-   {doProg, "prog"},
-   {doProg1, "prog1"},
-   {doProg2, "prog2"},
-   {doProp, "prop"},
-   {doPropCol, "::"},
-   {doProve, "prove"},
-   {doPush, "push"},
-   {doPush1, "push1"},
-   {doPut, "put"},
-   {doPutl, "putl"},
-   {doQueue, "queue"},
-   {doQuit, "quit"},
-   {doRand, "rand"},
-   {doRank, "rank"},
-   {doRead, "read"},
-   {doRem, "%"},
-   {doReplace, "replace"},
-   {doRest, "rest"},
-   {doReverse, "reverse"},
-   {doRot, "rot"},
-   {doRun, "run"},
-   {doSave, "save"},
-   {doSect, "sect"},
-   {doSeed, "seed"},
-   {doSeek, "seek"},
-   {doSemicol, ";"},
-   {doSend, "send"},
-   {doSet, "set"},
-   {doSetCol, "=:"},
-   {doSetq, "setq"},
-   {doShift, ">>"},
-   {doSize, "size"},
-   {doSkip, "skip"},
-   {doSort, "sort"},
-   {doSpace, "space"},
-   {doSplit, "split"},
-   {doSpQ, "sp?"},
-   {doSqrt, "sqrt"},
-   {doState, "state"},
-   {doStem, "stem"},
-   {doStr, "str"},
-   {doStrip, "strip"},
-   {doStrQ, "str?"},
-   {doSub, "-"},
-   {doSum, "sum"},
-   {doSuper, "super"},
-   {doSym, "sym"},
-   {doSymQ, "sym?"},
-   {doT, "t"},
-   {doTail, "tail"},
-   {doText, "text"},
-   {doThrow, "throw"},
-   {doTill, "till"},
-   {doTrace, "$"},
-   {doTrim, "trim"},
-   {doTry, "try"},
-   {doType, "type"},
-   {doUnify, "unify"},
-   {doUnless, "unless"},
-   {doUntil, "until"},
-   {doUp, "up"},
-   {doUppQ, "upp?"},
-   {doUppc, "uppc"},
-   {doUse, "use"},
-   {doVal, "val"},
-   {doWhen, "when"},
-   {doWhile, "while"},
-   {doWith, "with"},
-   {doXchg, "xchg"},
-   {doXor, "xor"},
-   {doYoke, "yoke"},
-   {doZap, "zap"},
-   {doZero, "zero"},
-};
+#include "symtab.h"
+
+#define SYMBOLS ((int)(sizeof(Symbols)/sizeof(symInit)))
+
+/* The built-in functions stay in ROM, sorted by name at build time.
+ * They are looked up by binary search, and only interned when first
+ * referenced. */
+static byte SymUsed[(SYMBOLS+7)/8];
+
+static int romIdx(any nm) {
+   int i, c, lo, hi, mid, n;
+   word w;
+   char buf[SYMLEN+1];
+
+   for (n = 0, c = getByte1(&i, &w, &nm);  c;  c = getByte(&i, &w, &nm)) {
+      if (n == SYMLEN)
+         return -1;
+      buf[n++] = c;
+   }
+   buf[n] = '\0';
+   for (lo = 0, hi = SYMBOLS-1;  lo <= hi;) {
+      mid = (lo + hi) / 2;
+      if ((n = strcmp(buf, Symbols[mid].name)) == 0)
+         return mid;
+      if (n < 0)
+         hi = mid - 1;
+      else
+         lo = mid + 1;
+   }
+   return -1;
+}
+
+/* Materialize a built-in function symbol */
+any romSym(any sym) {
+   int i;
+   any x;
+   cell c1;
+
+   if ((i = romIdx(name(sym))) < 0  ||  SymUsed[i/8] & 1 << i%8)
+      return NULL;
+   SymUsed[i/8] |= 1 << i%8;
+   Push(c1, sym);
+   tail(x = consSym(boxSubr(Symbols[i].code), 0)) = name(sym);
+   drop(c1);
+   return x;
+}
+
+/* Intern all remaining built-in functions */
+void romAll(void) {
+   int i;
+
+   for (i = 0; i < SYMBOLS; ++i)
+      if (!(SymUsed[i/8] & 1 << i%8))
+         intern(mkSym((byte*)Symbols[i].name), Intern);
+}
 
 static any initSym(any v, char *s) {
    any x;
@@ -303,8 +76,7 @@ static any initSym(any v, char *s) {
 #include "common.h"
 
 void initSymbols(void) {
-   int i;
-
+   memset(SymUsed, 0, sizeof(SymUsed));
    Nil = symPtr(Avail),  Avail = Avail->car->car;  // Allocate 2 cells for NIL
    tail(Nil) = txt(83 | 73<<7 | 79<<14);
    val(Nil) = tail(Nil+1) = val(Nil+1) = Nil;
@@ -312,6 +84,8 @@ void initSymbols(void) {
    intern(Nil, Intern);
    Meth  = initSym(boxSubr(doMeth), "meth");
    Quote = initSym(boxSubr(doQuote), "quote");
+   Exec = consSym(boxSubr(doExec), 0);
+   Arr = consSym(Nil, 0);
 
 // system timer symbols.
 #ifdef PICOLISP_MOD_TIMER
@@ -391,12 +165,10 @@ void initSymbols(void) {
    This  = initSym(Nil, "This");
    Dbg   = initSym(Nil, "*Dbg");
    Scl   = initSym(Zero, "*Scl");
+   Comp  = initSym(Nil, "*Compile");
    Class = initSym(Nil, "*Class");
    Up    = initSym(Nil, "^");
    Err   = initSym(Nil, "*Err");
    Msg   = initSym(Nil, "*Msg");
    Bye   = initSym(Nil, "*Bye");  // Last unremovable symbol
-
-   for (i = 0; i < (int)(sizeof(Symbols)/sizeof(symInit)); ++i)
-      initSym(boxSubr(Symbols[i].code), Symbols[i].name);
 }
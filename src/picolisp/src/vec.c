@@ -0,0 +1,253 @@
+/* Fixed-point vector primitives
+ *
+ * Vectors are lists of numbers with '*Scl' decimal places. Products are
+ * summed exactly and rounded once at the end, half away from zero. The
+ * results don't depend on the word size of the target. Arguments may
+ * also be arrays from arr.c, which are read as lists of their elements.
+ * Results are lists in both cases.
+ */
+
+#include "pico.h"
+
+#define VEC_CHUNK       128  // Short products summable in a dlong
+
+/* Exact sum of products */
+typedef struct vacc {
+   dlong n;    // Pending sum of short products
+   int k;      // Number of pending products
+   cell sum;   // Flushed sum
+} vacc;
+
+static void accInit(vacc *a) {
+   a->n = 0,  a->k = 0;
+   Push(a->sum, Zero);
+}
+
+static void accFlush(vacc *a) {
+   if (a->n)
+      data(a->sum) = numAdd(data(a->sum), boxDlong(a->n));
+   a->n = 0,  a->k = 0;
+}
+
+static void accMul(vacc *a, any x, any y) {
+   if (isShort(x)  &&  isShort(y)) {
+      a->n += (dlong)unBox(x) * unBox(y);
+      if (++a->k == VEC_CHUNK)
+         accFlush(a);
+   }
+   else {
+      accFlush(a);
+      data(a->sum) = numAdd(data(a->sum), numMul(x, y));
+   }
+}
+
+/* Rounded division 'x / d' */
+static any rndDiv(any x, any d) {
+   long n;
+   cell c1;
+
+   if (isShort(x)  &&  isShort(d)) {
+      n = unBox(x);
+      return box((n < 0? n - unBox(d)/2 : n + unBox(d)/2) / unBox(d));
+   }
+   Push(c1, x);
+   data(c1) = bigAdd(data(c1), numDiv(d, box(2), NO), numCmp(x, Zero) < 0);
+   return numDiv(Pop(c1), d, NO);
+}
+
+/* Rounded sum divided by 'd', drops the accumulator */
+static any accDiv(vacc *a, any d) {
+   any x;
+   dlong n;
+
+   if (data(a->sum) == Zero  &&  isShort(d)) {
+      drop(a->sum);
+      n = a->n < 0? a->n - unBox(d)/2 : a->n + unBox(d)/2;
+      n /= unBox(d);
+      return n <= SHORT_MAX  &&  n >= -SHORT_MAX? box((long)n) : boxDlong(n);
+   }
+   accFlush(a);
+   x = rndDiv(data(a->sum), d);
+   drop(a->sum);
+   return x;
+}
+
+/* 10 ^ *Scl */
+static any sclDiv(any ex) {
+   long n = xNum(ex, val(Scl));
+   any d = One;
+
+   if (n < 0)
+      argError(ex, val(Scl));
+   while (--n >= 0)
+      d = numMul(d, box(10));
+   return d;
+}
+
+/* Evaluate a numeric list or array argument */
+static any evVec(any ex, any x) {
+   any y;
+
+   x = EVAL(car(x));
+   if (isCell(x)  &&  car(x) == Arr)
+      return arrList(ex,x);
+   NeedLst(ex,x);
+   for (y = x;  isCell(y);  y = cdr(y))
+      NeedNum(ex,car(y));
+   return x;
+}
+
+// (vdot 'lst1 'lst2) -> num
+any doVdot(any ex) {
+   any x, y;
+   vacc a;
+   cell c1, c2, c3;
+
+   x = cdr(ex),  Push(c1, evVec(ex,x));
+   x = cdr(x),  Push(c2, evVec(ex,x));
+   Push(c3, sclDiv(ex));
+   accInit(&a);
+   for (x = data(c1), y = data(c2);  isCell(x) && isCell(y);  x = cdr(x), y = cdr(y))
+      accMul(&a, car(x), car(y));
+   x = accDiv(&a, data(c3));
+   drop(c1);
+   return x;
+}
+
+// (vscale 'lst 'num) -> lst
+any doVscale(any ex) {
+   any x, y, z;
+   vacc a;
+   cell c1, c2, c3, res;
+
+   x = cdr(ex),  Push(c1, evVec(ex,x));
+   x = cdr(x),  Push(c2, EVAL(car(x)));
+   NeedNum(ex,data(c2));
+   Push(c3, sclDiv(ex));
+   Push(res, z = Nil);
+   for (x = data(c1);  isCell(x);  x = cdr(x)) {
+      accInit(&a);
+      accMul(&a, car(x), data(c2));
+      y = accDiv(&a, data(c3));
+      if (isNil(data(res)))
+         data(res) = z = cons(y, Nil);
+      else
+         z = cdr(z) = cons(y, Nil);
+   }
+   drop(c1);
+   return data(res);
+}
+
+// (vadd 'lst1 'lst2) -> lst
+any doVadd(any ex) {
+   any x, y, z;
+   cell c1, c2, res;
+
+   x = cdr(ex),  Push(c1, evVec(ex,x));
+   x = cdr(x),  Push(c2, evVec(ex,x));
+   Push(res, z = Nil);
+   for (x = data(c1), y = data(c2);  isCell(x) && isCell(y);  x = cdr(x), y = cdr(y)) {
+      if (isNil(data(res)))
+         data(res) = z = cons(numAdd(car(x), car(y)), Nil);
+      else
+         z = cdr(z) = cons(numAdd(car(x), car(y)), Nil);
+   }
+   drop(c1);
+   return data(res);
+}
+
+// (vfir 'lst 'lst2) -> lst
+any doVfir(any ex) {
+   any x, y, z;
+   int i, j, k, n;
+   vacc a;
+   cell c1, c2, c3, res;
+
+   x = cdr(ex),  Push(c1, evVec(ex,x));
+   x = cdr(x),  Push(c2, evVec(ex,x));
+   NeedPair(ex,data(c2));
+   Push(c3, sclDiv(ex));
+   Push(res, z = Nil);
+   n = length(data(c2));
+   {
+      any c[n], w[n];
+
+      for (i = 0, x = data(c2);  i < n;  ++i, x = cdr(x))
+         c[i] = car(x),  w[i] = Zero;
+      for (j = 0, x = data(c1);  isCell(x);  x = cdr(x)) {
+         w[j] = car(x);
+         accInit(&a);
+         for (i = 0, k = j;  i < n;  ++i) {
+            accMul(&a, c[i], w[k]);
+            if (--k < 0)
+               k = n - 1;
+         }
+         y = accDiv(&a, data(c3));
+         if (isNil(data(res)))
+            data(res) = z = cons(y, Nil);
+         else
+            z = cdr(z) = cons(y, Nil);
+         if (++j == n)
+            j = 0;
+      }
+   }
+   drop(c1);
+   return data(res);
+}
+
+// (vcum 'lst) -> lst
+any doVcum(any ex) {
+   any x, z;
+   cell c1, res;
+
+   Push(c1, evVec(ex, cdr(ex)));
+   Push(res, Nil);
+   if (isCell(x = data(c1))) {
+      data(res) = z = cons(car(x), Nil);
+      while (isCell(x = cdr(x)))
+         z = cdr(z) = cons(numAdd(car(z), car(x)), Nil);
+   }
+   drop(c1);
+   return data(res);
+}
+
+// (vmin 'lst) -> num
+any doVmin(any ex) {
+   any x, y;
+
+   if (!isCell(x = evVec(ex, cdr(ex))))
+      return Nil;
+   for (y = car(x);  isCell(x = cdr(x));)
+      if (numCmp(car(x), y) < 0)
+         y = car(x);
+   return y;
+}
+
+// (vmax 'lst) -> num
+any doVmax(any ex) {
+   any x, y;
+
+   if (!isCell(x = evVec(ex, cdr(ex))))
+      return Nil;
+   for (y = car(x);  isCell(x = cdr(x));)
+      if (numCmp(car(x), y) > 0)
+         y = car(x);
+   return y;
+}
+
+// (vmean 'lst) -> num
+any doVmean(any ex) {
+   any x;
+   long n;
+   cell c1, c2;
+
+   if (!isCell(x = evVec(ex, cdr(ex))))
+      return Nil;
+   Push(c1, x);
+   Push(c2, car(x));
+   for (n = 1;  isCell(x = cdr(x));  ++n)
+      data(c2) = numAdd(data(c2), car(x));
+   x = rndDiv(data(c2), box(n));
+   drop(c1);
+   return x;
+}
@@ -29,7 +29,7 @@ else :
 
 # Standard GCC Flags
 if comp[ 'lang' ] == 'picolisp':
-  comp.Append(CCFLAGS = ['-ffunction-sections','-falign-functions','-fdata-sections','-fno-strict-aliasing','-Wall','-DBOOTLOADER_%s' %comp['bootloader'].upper()])
+  comp.Append(CCFLAGS = ['-ffunction-sections','-falign-functions=8','-fdata-sections','-fno-strict-aliasing','-Wall','-DBOOTLOADER_%s' %comp['bootloader'].upper()])
 else:
   comp.Append(CCFLAGS = ['-ffunction-sections','-fdata-sections','-fno-strict-aliasing','-Wall','-DBOOTLOADER_%s' %comp['bootloader'].upper()])
 